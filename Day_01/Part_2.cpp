@@ -1,81 +1,32 @@
-#include <iostream>
-#include <fstream>
-#include <vector>
-#include <SmartString.h>
+#include <array>
+#include <optional>
+#include <string_view>
+#include <MultiPatternMatcher.h>
+#include <ParallelLineSum.h>
 
-class ProgressiveWordFinder {
-private:
-    int value;
-    std::string repr;
-    int current_index;
-public:
-    ProgressiveWordFinder(int val, std::string rep) : value(val), repr(rep), current_index(-1) {}
-    int checkNext(char c) {
-        if(repr[++current_index] != c) {
-            current_index = -1;
-            if(repr[0] == c) {
-                current_index = 0;
-            }
-            return -1;
-        }
-        if(current_index == (repr.length() - 1)) {
-            current_index = -1;
-            return value;
-        }
-        return -1;
-    }
+using Utilities::MultiPatternMatcher;
+
+// digit i + 1 is matched by both DIGIT_PATTERNS[i] and DIGIT_PATTERNS[i + 9]
+constexpr std::array<std::string_view, 18> DIGIT_PATTERNS {
+        "1", "2", "3", "4", "5", "6", "7", "8", "9",
+        "one", "two", "three", "four", "five", "six", "seven", "eight", "nine"
 };
 
-std::vector<ProgressiveWordFinder> createWords() {
-    return std::vector<ProgressiveWordFinder> {
-            {1, "1"},
-            {2, "2"},
-            {3, "3"},
-            {4, "4"},
-            {5, "5"},
-            {6, "6"},
-            {7, "7"},
-            {8, "8"},
-            {9, "9"},
-            {1, "one"},
-            {2, "two"},
-            {3, "three"},
-            {4, "four"},
-            {5, "five"},
-            {6, "six"},
-            {7, "seven"},
-            {8, "eight"},
-            {9, "nine"}
-    };
+// the forward automaton stops at the first digit, the one built from reversed words scans in from
+// the end of the line and stops at the last, so the middle of a line is never read
+const MultiPatternMatcher forward(DIGIT_PATTERNS);
+const MultiPatternMatcher backward(DIGIT_PATTERNS, MultiPatternMatcher::Direction::Backward);
+
+int digitValue(const std::optional<MultiPatternMatcher::Match>& match) {
+    return match ? static_cast<int>(match->patternIndex % 9) + 1 : 0;
 }
 
-int main() {
-    std::ifstream input_file("/mnt/c/Users/Matt/CLionProjects/advent_of_code_2023/Day_01/input_data/input.txt");
-    std::string   l;
-    int sum = 0;
-    while(std::getline(input_file, l))
-    {
-        int first_digit = -1; int second_digit = -1;
-        Utilities::SmartString line(l);
-        line.strip();
-        std::vector<ProgressiveWordFinder> words = createWords();
-        for(char c : line) {
-            for(auto& word : words) {
-                auto result = word.checkNext(c);
-                if(result >= 0) {
-                    if(first_digit < 0) {
-                        first_digit = result;
-                    }
-                    second_digit = result;
-                }
-            }
-        }
-        auto val = std::max(first_digit, 0) * 10 + std::max(second_digit, 0);
-        std::cout << line << " -> " << val << std::endl;
-        sum += val;
-    }
-    input_file.close();
-    std::cout << std::endl << sum << std::endl;
+int calibrationValue(const std::string_view line) {
+    return digitValue(forward.findFirst(line)) * 10 + digitValue(backward.findFirst(line));
+}
+
+int main(int argc, char** argv) {
+    const char* path = "/mnt/c/Users/Matt/CLionProjects/advent_of_code_2023/Day_01/input_data/input.txt";
     // Correct Answer: 53312
-    return 0;
-}
\ No newline at end of file
+    return Utilities::printLineSum(argc, argv, path, calibrationValue);
+}
@@ -1,65 +1,96 @@
 #include <iostream>
-#include <fstream>
-#include <vector>
-#include <SmartString.h>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <stdexcept>
+#include <MappedFile.h>
 
-struct Game {
-    int id{};
-    std::vector<std::map<std::string, int>> distributions{};
-};
+// the bag holds 12 red, 13 green and 14 blue cubes
+constexpr uint32_t MAX_RED = 12;
+constexpr uint32_t MAX_GREEN = 13;
+constexpr uint32_t MAX_BLUE = 14;
 
-int main() {
-    std::ifstream input_file("/mnt/c/Users/Matt/CLionProjects/advent_of_code_2023/Day_02/input_data/input.txt");
-    std::string   l;
-
-    std::vector<Game> games;
-    while(std::getline(input_file, l))
-    {
-        Utilities::SmartString line(l);
-        auto splitLine = line.split<Utilities::SmartString>(":");
-
-        int gameid = splitLine[0].split<Utilities::SmartString>()[1].convert<int>();
-
-        Game currentGame;
-        currentGame.id = gameid;
-
-        auto distributions = splitLine[1].split<Utilities::SmartString>(";");
+// The color names differ in their first letter, which is all the parser looks at.
+uint32_t limitOf(const char firstLetter) {
+    switch(firstLetter) {
+        case 'r': return MAX_RED;
+        case 'g': return MAX_GREEN;
+        case 'b': return MAX_BLUE;
+        default: throw std::invalid_argument(std::string("Unknown cube color starting with '") + firstLetter + "'");
+    }
+}
 
-        for(auto distribution : distributions) {
-            distribution.strip();
-            std::map<std::string, int> distributionMap {{"red", 0}, {"blue", 0}, {"green", 0}};
+// Parses "Game N: 3 blue, 4 red; 1 red, 2 green" records straight from the buffer in one pass and sums
+// the IDs of the games the bag could have produced. A game is ruled out by the first count that is
+// over its color's limit, so only the current game's ID and whether it is still possible are kept.
+long long sumPossibleGameIds(const std::string_view input) {
+    enum class State {
+        Header,   // "Game "
+        GameId,
+        Count,    // a number, or the spaces and separators around it
+        ColorName
+    };
 
-            auto colorDistribution = distribution.split<Utilities::SmartString>(", ");
+    long long possibleIdSum = 0;
+    State state = State::Header;
+    long long id = 0;
+    uint32_t count = 0;
+    bool possible = false;
 
-            for(auto color_number_pair : colorDistribution) {
-                auto cnp = color_number_pair.split<Utilities::SmartString>();
-                distributionMap[cnp[1].str()] = cnp[0].convert<int>();
-            }
-            currentGame.distributions.push_back(distributionMap);
+    const auto finishGame = [&] {
+        if(possible) {
+            possibleIdSum += id;
         }
-        games.push_back(currentGame);
-    }
-    input_file.close();
-
-    int idsum = 0;
-    std::map<std::string, int> max_values {
-        {"red", 12}, {"blue", 14}, {"green", 13}
+        possible = false;
     };
-    for(auto& game : games) {
-        bool max_value_exceeded = false;
-        for(auto& distribution : game.distributions) {
-            for(const auto& max_value_pair : max_values) {
-                if(distribution[max_value_pair.first] > max_value_pair.second) {
-                    max_value_exceeded = true;
-                }
-            }
+
+    for(const char c : input) {
+        if(c == '\n') {
+            finishGame();
+            state = State::Header;
+            continue;
         }
-        if(!max_value_exceeded) {
-            idsum += game.id;
+        const bool isDigit = c >= '0' && c <= '9';
+        switch(state) {
+            case State::Header:
+                if(isDigit) {
+                    id = c - '0';
+                    possible = true;
+                    state = State::GameId;
+                }
+                break;
+            case State::GameId:
+                if(isDigit) {
+                    id = id * 10 + (c - '0');
+                } else if(c == ':') {
+                    count = 0;
+                    state = State::Count;
+                }
+                break;
+            case State::Count:
+                if(isDigit) {
+                    count = count * 10 + (c - '0');
+                } else if(c >= 'a' && c <= 'z') {
+                    possible = possible && count <= limitOf(c);
+                    state = State::ColorName;
+                }
+                break;
+            case State::ColorName:
+                if(c == ',' || c == ';') {
+                    count = 0;
+                    state = State::Count;
+                }
+                break;
         }
     }
+    finishGame();
+    return possibleIdSum;
+}
+
+int main() {
+    const Utilities::MappedFile input("/mnt/c/Users/Matt/CLionProjects/advent_of_code_2023/Day_02/input_data/input.txt");
 
-    std::cout << idsum << std::endl;
+    std::cout << sumPossibleGameIds(input.view()) << std::endl;
 
     return 0;
 }
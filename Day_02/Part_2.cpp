@@ -1,61 +1,122 @@
 #include <iostream>
-#include <fstream>
-#include <vector>
-#include <SmartString.h>
+#include <string>
+#include <string_view>
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <MappedFile.h>
 
-struct Game {
-    int id{};
-    std::vector<std::map<std::string, int>> distributions{};
+enum class Color : uint8_t {
+    Red,
+    Green,
+    Blue
 };
 
-int main() {
-    std::ifstream input_file("/mnt/c/Users/Matt/CLionProjects/advent_of_code_2023/Day_02/input_data/input.txt");
-    std::string   l;
-
-    std::vector<Game> games;
-    while(std::getline(input_file, l))
-    {
-        Utilities::SmartString line(l);
-        auto splitLine = line.split<Utilities::SmartString>(":");
-        int gameid = splitLine[0].split<Utilities::SmartString>()[1].convert<int>();
-        Game currentGame;
-        currentGame.id = gameid;
-        auto distributions = splitLine[1].split<Utilities::SmartString>(";");
-        for(auto distribution : distributions) {
-            distribution.strip();
-            std::map<std::string, int> distributionMap;
-            auto colorDistribution = distribution.split<Utilities::SmartString>(", ");
-            for(auto color_number_pair : colorDistribution) {
-                auto cnp = color_number_pair.split<Utilities::SmartString>();
-                distributionMap[cnp[1].str()] = cnp[0].convert<int>();
-            }
-            currentGame.distributions.push_back(distributionMap);
-        }
-        games.push_back(currentGame);
+constexpr size_t NUM_COLORS = 3;
+
+// One count per color, packed into three bytes. Each game is reduced to a single Draw, the largest
+// count of each color drawn in it.
+using Draw = std::array<uint8_t, NUM_COLORS>;
+
+// The color names differ in their first letter, which is all the parser looks at.
+Color colorOf(const char firstLetter) {
+    switch(firstLetter) {
+        case 'r': return Color::Red;
+        case 'g': return Color::Green;
+        case 'b': return Color::Blue;
+        default: throw std::invalid_argument(std::string("Unknown cube color starting with '") + firstLetter + "'");
+    }
+}
+
+uint8_t toCount(const uint32_t count) {
+    if(count > UINT8_MAX) {
+        throw std::out_of_range("Cube count " + std::to_string(count) + " does not fit in a Draw");
+    }
+    return static_cast<uint8_t>(count);
+}
+
+// Lane-wise maximum of two draws.
+Draw maxOf(const Draw& lhs, const Draw& rhs) {
+    Draw result{};
+    for(size_t color = 0; color < NUM_COLORS; color++) {
+        result[color] = std::max(lhs[color], rhs[color]);
     }
-    input_file.close();
-
-    int total_power = 0;
-
-    for(auto& game : games) {
-        std::map<std::string, int> min_required_values {
-                {"red", 0},
-                {"blue", 0},
-                {"green", 0}
-        };
-        for(auto& distribution : game.distributions) {
-            for(const auto& value_pair : distribution) {
-                min_required_values[value_pair.first] = std::max(value_pair.second, min_required_values[value_pair.first]);
-            }
+    return result;
+}
+
+// Parses "Game N: 3 blue, 4 red; 1 red, 2 green" records straight from the buffer in one pass and sums
+// the power of each game, keeping only the draw being read and the running maximum draw of the current
+// game. Nothing is stored for earlier draws or games, and the game IDs are never parsed.
+long long sumGamePowers(const std::string_view input) {
+    enum class State {
+        Header,   // "Game N:"
+        Count,    // a number, or the spaces and separators around it
+        ColorName
+    };
+
+    long long totalPower = 0;
+    State state = State::Header;
+    uint32_t count = 0;
+    Draw draw{};
+    Draw maxima{};
+    bool inGame = false;
+
+    const auto finishGame = [&] {
+        if(!inGame) {
+            return;
         }
-        auto game_power = 1;
-        for(const auto& min_value_pair : min_required_values) {
-            game_power *= min_value_pair.second;
+        maxima = maxOf(maxima, draw);
+        // the fewest cubes that make every draw possible are the largest count drawn of each color
+        totalPower += static_cast<long long>(maxima[0]) * maxima[1] * maxima[2];
+        inGame = false;
+    };
+
+    for(const char c : input) {
+        if(c == '\n') {
+            finishGame();
+            state = State::Header;
+            continue;
+        }
+        const bool isDigit = c >= '0' && c <= '9';
+        switch(state) {
+            case State::Header:
+                if(c == ':') {
+                    draw = {};
+                    maxima = {};
+                    inGame = true;
+                    count = 0;
+                    state = State::Count;
+                }
+                break;
+            case State::Count:
+                if(isDigit) {
+                    count = count * 10 + (c - '0');
+                } else if(c >= 'a' && c <= 'z') {
+                    draw[static_cast<size_t>(colorOf(c))] = toCount(count);
+                    state = State::ColorName;
+                }
+                break;
+            case State::ColorName:
+                if(c == ',' || c == ';') {
+                    if(c == ';') {
+                        maxima = maxOf(maxima, draw);
+                        draw = {};
+                    }
+                    count = 0;
+                    state = State::Count;
+                }
+                break;
         }
-        total_power += game_power;
     }
+    finishGame();
+    return totalPower;
+}
+
+int main() {
+    const Utilities::MappedFile input("/mnt/c/Users/Matt/CLionProjects/advent_of_code_2023/Day_02/input_data/input.txt");
 
-    std::cout << total_power << std::endl;
+    std::cout << sumGamePowers(input.view()) << std::endl;
 
     return 0;
 }
@@ -1,77 +1,80 @@
 #include <iostream>
 #include <fstream>
+#include <string>
+#include <string_view>
 #include <vector>
-#include <cctype>
-#include <SmartString.h>
+#include <Grid2D.h>
+#include <CharGrid.h>
+#include "Schematic.h"
 
-struct Number {
-    int value{};
-    std::vector<std::pair<int, int>> coordinates{};
-};
+using Utilities::RowWindow;
 
-struct Symbol {
-    char sym{};
-    std::pair<int, int> coordinates{};
-
-public:
-    [[nodiscard]] bool isAdjacent(const Number& other) const {
-        for(const auto& coord : other.coordinates) {
-            if(std::abs(coordinates.first - coord.first) <= 1 &&
-               std::abs(coordinates.second - coord.second) <= 1) {
-                return true;
+// A number can only touch symbols in the rows directly above and below it, so each row is resolved
+// once the row after it has been read and only three rows are ever held.
+int streamPartNumberSum(std::istream& input) {
+    RowWindow window(EMPTY_CELL);
+    std::string next;
+    int sum = 0;
+    bool more = Utilities::readTrimmedLine(input, next);
+    window.push(std::move(next));
+    while(more || !window.rows[2].empty()) {
+        more = more && Utilities::readTrimmedLine(input, next);
+        window.push(more ? std::move(next) : std::string());
+        const std::string& row = window.rows[1];
+        for(size_t x = 0; x < row.length();) {
+            if(!isDigit(row[x])) {
+                x++;
+                continue;
+            }
+            const size_t start = x;
+            int value = 0;
+            for(; x < row.length() && isDigit(row[x]); x++) {
+                value = value * 10 + (row[x] - '0');
+            }
+            bool isPartNumber = false;
+            for(long long column = static_cast<long long>(start) - 1; column <= static_cast<long long>(x) && !isPartNumber; column++) {
+                isPartNumber = isSymbol(window.at(0, column)) || isSymbol(window.at(1, column)) || isSymbol(window.at(2, column));
+            }
+            if(isPartNumber) {
+                sum += value;
             }
         }
-        return false;
     }
-};
+    return sum;
+}
 
-int main() {
-    std::ifstream input_file("/mnt/c/Users/Matt/CLionProjects/advent_of_code_2023/Day_03/input_data/input.txt");
-    std::string   l;
-    std::vector<Number> numbers;
-    std::vector<Symbol> symbols;
-    int lineNumber = 0;
-    while(std::getline(input_file, l))
-    {
-        Utilities::SmartString line(l);
-        line.strip();
-        Utilities::SmartString currentNumberStr;
-        Number currentNumber;
-        for(int i = 0; i < line.length(); i++) {
-            if(std::isdigit(line[i])) {
-                currentNumberStr += line[i];
-                currentNumber.coordinates.emplace_back(i, lineNumber);
-            } else {
-                if(!currentNumberStr.isEmpty()) {
-                    currentNumber.value = currentNumberStr.convert<int>();
-                    numbers.push_back(currentNumber);
-                    currentNumber = Number();
-                    currentNumberStr.clear();
-                }
-                if(line[i] != '.') {
-                    symbols.push_back({
-                        .sym=line[i],
-                        .coordinates={i, lineNumber}
-                    });
-                }
+int main(int argc, char** argv) {
+    const char* path = "/mnt/c/Users/Matt/CLionProjects/advent_of_code_2023/Day_03/input_data/input.txt";
+    // --stream holds three rows at a time instead of the whole schematic
+    if(argc > 1 && std::string_view(argv[1]) == "--stream") {
+        std::ifstream input_file(path);
+        std::cout << streamPartNumberSum(input_file) << std::endl;
+        return 0;
+    }
+
+    const Utilities::Grid2D<char> schematic = Utilities::readCharGrid(path, EMPTY_CELL);
+    std::vector<int> values;
+    const Utilities::Grid2D<int> numberIds = labelNumbers(schematic, values);
+
+    // each symbol only looks at its 8 neighbours, and a number touching several symbols counts once
+    std::vector<bool> isPartNumber(values.size(), false);
+    for(size_t y = 0; y < schematic.getHeight(); y++) {
+        for(size_t x = 0; x < schematic.getWidth(); x++) {
+            if(!isSymbol(schematic(x, y))) {
+                continue;
             }
+            numberIds.forEachNeighbour(x, y, [&](size_t, size_t, const int id) {
+                if(id != NO_NUMBER) {
+                    isPartNumber[id] = true;
+                }
+            });
         }
-        if(!currentNumberStr.isEmpty()) {
-            currentNumber.value = currentNumberStr.convert<int>();
-            numbers.push_back(currentNumber);
-        }
-        lineNumber++;
     }
-    input_file.close();
 
     int sum = 0;
-
-    for(const auto& number : numbers) {
-        for(const auto& symbol : symbols) {
-            if(symbol.isAdjacent(number)) {
-                sum += number.value;
-                break;
-            }
+    for(size_t id = 0; id < values.size(); id++) {
+        if(isPartNumber[id]) {
+            sum += values[id];
         }
     }
 
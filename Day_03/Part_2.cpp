@@ -1,81 +1,99 @@
 #include <iostream>
 #include <fstream>
+#include <string>
+#include <string_view>
 #include <vector>
-#include <cctype>
-#include <SmartString.h>
+#include <array>
+#include <algorithm>
+#include <Grid2D.h>
+#include <CharGrid.h>
+#include "Schematic.h"
 
-struct Number {
-    int value{};
-    std::vector<std::pair<int, int>> coordinates{};
-};
+using Utilities::RowWindow;
 
-struct Symbol {
-    char sym{};
-    std::pair<int, int> coordinates{};
-
-public:
-    [[nodiscard]] bool isAdjacent(const Number& other) const {
-        for(const auto& coord : other.coordinates) {
-            if(std::abs(coordinates.first - coord.first) <= 1 &&
-               std::abs(coordinates.second - coord.second) <= 1) {
-                return true;
-            }
-        }
-        return false;
+// The value of the number covering column x of a window row, read outwards from that digit.
+int numberAround(const std::string& row, size_t x) {
+    while(x > 0 && isDigit(row[x - 1])) {
+        x--;
     }
-};
-
-int main() {
-    std::ifstream input_file("/mnt/c/Users/Matt/CLionProjects/advent_of_code_2023/Day_03/input_data/input.txt");
-    std::string   l;
-    std::vector<Number> numbers;
-    std::vector<Symbol> symbols;
-    int lineNumber = 0;
+    int value = 0;
+    for(; x < row.length() && isDigit(row[x]); x++) {
+        value = value * 10 + (row[x] - '0');
+    }
+    return value;
+}
 
-    while(std::getline(input_file, l))
-    {
-        Utilities::SmartString line(l);
-        line.strip();
-        Utilities::SmartString currentNumberStr;
-        Number currentNumber;
-        for(int i = 0; i < line.length(); i++) {
-            if(std::isdigit(line[i])) {
-                currentNumberStr += line[i];
-                currentNumber.coordinates.emplace_back(i, lineNumber);
-            } else {
-                if(!currentNumberStr.isEmpty()) {
-                    currentNumber.value = currentNumberStr.convert<int>();
-                    numbers.push_back(currentNumber);
-                    currentNumber = Number();
-                    currentNumberStr.clear();
+// A gear's numbers all lie in the rows directly above and below it, so each row is resolved once
+// the row after it has been read and only three rows are ever held.
+int streamGearRatioSum(std::istream& input) {
+    RowWindow window(EMPTY_CELL);
+    std::string next;
+    int gearRatioSum = 0;
+    bool more = Utilities::readTrimmedLine(input, next);
+    window.push(std::move(next));
+    while(more || !window.rows[2].empty()) {
+        more = more && Utilities::readTrimmedLine(input, next);
+        window.push(more ? std::move(next) : std::string());
+        const std::string& row = window.rows[1];
+        for(size_t x = 0; x < row.length(); x++) {
+            if(row[x] != '*') {
+                continue;
+            }
+            std::vector<int> adjacent;
+            for(size_t r = 0; r < 3; r++) {
+                const auto digitAt = [&](const long long column) {
+                    return isDigit(window.at(r, column));
+                };
+                // a digit above or below the gear joins the numbers on either side of it
+                if(digitAt(x)) {
+                    adjacent.push_back(numberAround(window.rows[r], x));
+                    continue;
                 }
-                if(line[i] == '*') {
-                    symbols.push_back({
-                        .sym=line[i],
-                        .coordinates={i, lineNumber}
-                    });
+                if(digitAt(static_cast<long long>(x) - 1)) {
+                    adjacent.push_back(numberAround(window.rows[r], x - 1));
+                }
+                if(digitAt(static_cast<long long>(x) + 1)) {
+                    adjacent.push_back(numberAround(window.rows[r], x + 1));
                 }
             }
+            if(adjacent.size() == 2) {
+                gearRatioSum += adjacent.front() * adjacent.back();
+            }
         }
-        if(!currentNumberStr.isEmpty()) {
-            currentNumber.value = currentNumberStr.convert<int>();
-            numbers.push_back(currentNumber);
-        }
-        lineNumber++;
     }
-    input_file.close();
+    return gearRatioSum;
+}
 
-    int gearRatioSum = 0;
+int main(int argc, char** argv) {
+    const char* path = "/mnt/c/Users/Matt/CLionProjects/advent_of_code_2023/Day_03/input_data/input.txt";
+    // --stream holds three rows at a time instead of the whole schematic
+    if(argc > 1 && std::string_view(argv[1]) == "--stream") {
+        std::ifstream input_file(path);
+        std::cout << streamGearRatioSum(input_file) << std::endl;
+        return 0;
+    }
+
+    const Utilities::Grid2D<char> schematic = Utilities::readCharGrid(path, EMPTY_CELL);
+    std::vector<int> values;
+    const Utilities::Grid2D<int> numberIds = labelNumbers(schematic, values);
 
-    for(const auto& symbol : symbols) {
-        std::vector<Number> adjacentNumbers;
-        for(const auto& number : numbers) {
-            if(symbol.isAdjacent(number)) {
-                adjacentNumbers.push_back(number);
+    // a gear is a '*' next to exactly two distinct numbers; a number can touch it through several digits
+    int gearRatioSum = 0;
+    for(size_t y = 0; y < schematic.getHeight(); y++) {
+        for(size_t x = 0; x < schematic.getWidth(); x++) {
+            if(schematic(x, y) != '*') {
+                continue;
+            }
+            std::array<int, 8> adjacentIds{};
+            size_t numAdjacent = 0;
+            numberIds.forEachNeighbour(x, y, [&](size_t, size_t, const int id) {
+                if(id != NO_NUMBER && std::find(adjacentIds.begin(), adjacentIds.begin() + numAdjacent, id) == adjacentIds.begin() + numAdjacent) {
+                    adjacentIds[numAdjacent++] = id;
+                }
+            });
+            if(numAdjacent == 2) {
+                gearRatioSum += values[adjacentIds[0]] * values[adjacentIds[1]];
             }
-        }
-        if(adjacentNumbers.size() == 2) {
-            gearRatioSum += adjacentNumbers.front().value * adjacentNumbers.back().value;
         }
     }
 
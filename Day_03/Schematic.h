@@ -0,0 +1,46 @@
+#ifndef DAY_03_SCHEMATIC_H
+#define DAY_03_SCHEMATIC_H
+
+#include <cctype>
+#include <cstddef>
+#include <vector>
+#include <Grid2D.h>
+
+// The rules of an engine schematic: '.' is empty, runs of digits within a row are numbers and
+// anything else is a symbol.
+
+// the cell that pads short lines and stands in for cells outside the schematic
+constexpr char EMPTY_CELL = '.';
+
+// no number covers a cell with this ID
+constexpr int NO_NUMBER = -1;
+
+inline bool isDigit(const char c) {
+    return std::isdigit(static_cast<unsigned char>(c)) != 0;
+}
+
+// anything that is neither empty nor part of a number
+inline bool isSymbol(const char c) {
+    return c != EMPTY_CELL && !isDigit(c);
+}
+
+// Labels every digit cell with the index in values of the number it belongs to; every other cell is NO_NUMBER.
+inline Utilities::Grid2D<int> labelNumbers(const Utilities::Grid2D<char>& schematic, std::vector<int>& values) {
+    Utilities::Grid2D<int> numberIds(schematic.getWidth(), schematic.getHeight(), NO_NUMBER);
+    for(size_t y = 0; y < schematic.getHeight(); y++) {
+        const auto row = schematic.row(y);
+        for(size_t x = 0; x < row.size(); x++) {
+            if(!isDigit(row[x])) {
+                continue;
+            }
+            if(x == 0 || numberIds(x - 1, y) == NO_NUMBER) {
+                values.push_back(0);
+            }
+            values.back() = values.back() * 10 + (row[x] - '0');
+            numberIds(x, y) = static_cast<int>(values.size()) - 1;
+        }
+    }
+    return numberIds;
+}
+
+#endif //DAY_03_SCHEMATIC_H
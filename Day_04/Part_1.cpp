@@ -1,62 +1,110 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <ranges>
+#include <array>
+#include <span>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
 #include <SmartString.h>
 
+// AoC card numbers are below 100, so a card's numbers fit in a 128-bit mask
+constexpr int MAX_NUMBER = 128;
+
+using NumberMask = std::array<uint64_t, 2>;
+
+void addNumber(NumberMask& mask, const int number) {
+    if(number < 0 || number >= MAX_NUMBER) {
+        throw std::out_of_range("Card number " + std::to_string(number) + " does not fit in a NumberMask");
+    }
+    mask[number / 64] |= uint64_t{1} << (number % 64);
+}
+
 struct Ticket {
-    std::vector<int> winningNumbers{};
-    std::vector<int> playerNumbers{};
-
-    [[nodiscard]] int getScore() const {
-        int score = 0;
-        for(auto number : winningNumbers) {
-            if(std::find(playerNumbers.begin(), playerNumbers.end(), number) != playerNumbers.end())
-            {
-                if(score < 1) {
-                    score = 1;
-                } else {
-                    score *= 2;
-                }
-            }
+    NumberMask winningNumbers{};
+    NumberMask playerNumbers{};
+};
+
+// The masks of many tickets, one array per mask word, so matches are counted in a single branch-free
+// loop over contiguous words that the compiler can vectorise.
+struct TicketBatch {
+    std::vector<uint64_t> winningLow{};
+    std::vector<uint64_t> winningHigh{};
+    std::vector<uint64_t> playerLow{};
+    std::vector<uint64_t> playerHigh{};
+
+    void add(const Ticket& ticket) {
+        winningLow.push_back(ticket.winningNumbers[0]);
+        winningHigh.push_back(ticket.winningNumbers[1]);
+        playerLow.push_back(ticket.playerNumbers[0]);
+        playerHigh.push_back(ticket.playerNumbers[1]);
+    }
+
+    [[nodiscard]] size_t size() const {
+        return winningLow.size();
+    }
+
+    // matches[i] is the number of winning numbers on the i-th ticket added
+    void countMatches(std::span<int> matches) const {
+        for(size_t i = 0; i < matches.size() && i < size(); i++) {
+            matches[i] = std::popcount(winningLow[i] & playerLow[i]) + std::popcount(winningHigh[i] & playerHigh[i]);
         }
-        return score;
     }
 };
 
+bool isNotEmpty(const Utilities::SmartStringView& token) {
+    return !token.isEmpty();
+}
+
+// Parses "Card N: winning numbers | player numbers". The line and its halves are allocated with
+// allocator, so an Arena can hand all of them back at once.
+Ticket parseTicket(const std::string& l, const Utilities::SmartString::allocator_type& allocator) {
+    const Utilities::SmartString line(l, allocator);
+    const auto colon = line.view().findSubstring(":");
+    const auto bar = line.view().findSubstring("|");
+    Utilities::SmartString winningText = line.getSubstring(colon + 1, bar - 1);
+    Utilities::SmartString playerText = line.getSubstring(bar + 1, line.length() - 1);
+    auto winningNumbers = winningText.strip().tokens() | std::views::filter(isNotEmpty);
+    auto playerNumbers = playerText.strip().tokens() | std::views::filter(isNotEmpty);
+
+    Ticket currentTicket;
+
+    for(auto number : winningNumbers) {
+        addNumber(currentTicket.winningNumbers, number.convert<int>());
+    }
+
+    for(auto number : playerNumbers) {
+        addNumber(currentTicket.playerNumbers, number.convert<int>());
+    }
+
+    return currentTicket;
+}
+
 int main() {
     std::ifstream input_file("/mnt/c/Users/Matt/CLionProjects/advent_of_code_2023/Day_04/input_data/input.txt");
     std::string   l;
-    std::vector<Ticket> tickets;
+    TicketBatch tickets;
+    // every line's strings come from this buffer, which is reused once the line is parsed
+    std::array<std::byte, 1024> lineBuffer{};
+    Utilities::SmartString::Arena arena(lineBuffer);
 
     while(std::getline(input_file, l))
     {
-        Utilities::SmartString line(l);
-        auto splitLine = line.split<Utilities::SmartString>(":");
-        auto numbers = splitLine[1].strip().split<Utilities::SmartString>("|");
-        auto winningNumbers = numbers[0].strip().split<Utilities::SmartString>();
-        auto playerNumbers = numbers[1].strip().split<Utilities::SmartString>();
-
-        Ticket currentTicket;
-
-        for(auto& number : winningNumbers) {
-            if(!number.strip().isEmpty()) {
-                currentTicket.winningNumbers.push_back(number.convert<int>());
-            }
-        }
-
-        for(auto& number : playerNumbers) {
-            if(!number.strip().isEmpty()) {
-                currentTicket.playerNumbers.push_back(number.convert<int>());
-            }
-        }
-
-        tickets.push_back(currentTicket);
+        tickets.add(parseTicket(l, arena.getAllocator()));
+        arena.release();
     }
     input_file.close();
 
+    std::vector<int> matches(tickets.size());
+    tickets.countMatches(matches);
+
     int totalScore = 0;
-    for(const auto& ticket : tickets) {
-        totalScore += ticket.getScore();
+    for(const int numMatches : matches) {
+        // the first match is worth 1 point and each further one doubles it
+        totalScore += numMatches > 0 ? 1 << (numMatches - 1) : 0;
     }
 
     std::cout << totalScore << std::endl;
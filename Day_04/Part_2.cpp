@@ -1,75 +1,139 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
-#include <map>
+#include <ranges>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <SmartString.h>
 
+// AoC card numbers are below 100, so a card's numbers fit in a 128-bit mask
+constexpr int MAX_NUMBER = 128;
+
+using NumberMask = std::array<uint64_t, 2>;
+
+void addNumber(NumberMask& mask, const int number) {
+    if(number < 0 || number >= MAX_NUMBER) {
+        throw std::out_of_range("Card number " + std::to_string(number) + " does not fit in a NumberMask");
+    }
+    mask[number / 64] |= uint64_t{1} << (number % 64);
+}
+
 struct Ticket {
-    int cardNumber{};
-    std::vector<int> winningNumbers{};
-    std::vector<int> playerNumbers{};
+    NumberMask winningNumbers{};
+    NumberMask playerNumbers{};
 
     [[nodiscard]] int getNumberOfWinningNumbers() const {
-        int result = 0;
-        for(auto number : winningNumbers) {
-            if(std::find(playerNumbers.begin(), playerNumbers.end(), number) != playerNumbers.end())
-            {
-                result ++;
-            }
+        return std::popcount(winningNumbers[0] & playerNumbers[0]) + std::popcount(winningNumbers[1] & playerNumbers[1]);
+    }
+};
+
+// Counts scratchcard copies as cards arrive, in card order. Card i's copies each win one copy of the
+// next `matches` cards, so instead of handing them out one at a time the count is added to a running
+// total when it starts applying and taken off again when it stops (a difference array), which keeps
+// each card O(1) however many copies there are. Only the next few cards can have pending changes, so
+// the differences live in a ring buffer just longer than the largest match count seen so far.
+class CopyCounter {
+private:
+    // expiring[i % window] is the number of copies that stop applying at card i
+    std::vector<uint64_t> expiring{};
+    uint64_t active = 0;
+    uint64_t total = 0;
+    size_t numCards = 0;
+
+    static uint64_t checkedAdd(const uint64_t lhs, const uint64_t rhs) {
+        uint64_t result;
+        if(__builtin_add_overflow(lhs, rhs, &result)) {
+            throw std::overflow_error("Scratchcard copy count does not fit in 64 bits");
         }
         return result;
     }
-};
 
-int main() {
-    std::ifstream input_file("/mnt/c/Users/Matt/CLionProjects/advent_of_code_2023/Day_04/input_data/input.txt");
-    std::string   l;
-    std::vector<Ticket> tickets;
-    while(std::getline(input_file, l))
-    {
-        Utilities::SmartString line(l);
-        auto splitLine = line.split<Utilities::SmartString>(":");
-        auto cardNumber = splitLine[0].strip().split<Utilities::SmartString>().back().strip().convert<int>();
-        auto numbers = splitLine[1].strip().split<Utilities::SmartString>("|");
-        auto winningNumbers = numbers[0].strip().split<Utilities::SmartString>();
-        auto playerNumbers = numbers[1].strip().split<Utilities::SmartString>();
-
-        Ticket currentTicket;
-        currentTicket.cardNumber = cardNumber;
-
-        for(auto& number : winningNumbers) {
-            if(!number.strip().isEmpty()) {
-                currentTicket.winningNumbers.push_back(number.convert<int>());
-            }
+    // Re-lays the pending differences after `card` out over a longer ring.
+    void growWindow(const size_t window, const size_t card) {
+        std::vector<uint64_t> grown(window, 0);
+        for(size_t pending = card + 1; pending < card + expiring.size(); pending++) {
+            grown[pending % window] = expiring[pending % expiring.size()];
         }
+        expiring = std::move(grown);
+    }
 
-        for(auto& number : playerNumbers) {
-            if(!number.strip().isEmpty()) {
-                currentTicket.playerNumbers.push_back(number.convert<int>());
+public:
+    // Adds the next card and returns how many copies of it there are.
+    uint64_t addCard(const int matches) {
+        const size_t card = numCards++;
+        if(!expiring.empty()) {
+            uint64_t& ending = expiring[card % expiring.size()];
+            active -= ending;
+            ending = 0;
+        }
+        const uint64_t copies = checkedAdd(active, 1);
+        total = checkedAdd(total, copies);
+        if(matches > 0) {
+            // the copies stop at card + matches + 1, which must not wrap onto the current card
+            const size_t window = static_cast<size_t>(matches) + 2;
+            if(expiring.size() < window) {
+                growWindow(window, card);
             }
+            active = checkedAdd(active, copies);
+            expiring[(card + matches + 1) % expiring.size()] += copies;
         }
+        return copies;
+    }
 
-        tickets.push_back(currentTicket);
+    [[nodiscard]] uint64_t getTotal() const {
+        return total;
     }
-    input_file.close();
+};
 
-    std::map<int, int> ticketMap;
-    for(const auto& ticket : tickets) {
-        int score = ticket.getNumberOfWinningNumbers();
-        ticketMap[ticket.cardNumber] += 1;
-        for(int j = 0; j < ticketMap[ticket.cardNumber]; j++) {
-            for (int i = score; i > 0; i--) {
-                ticketMap[ticket.cardNumber + i] += 1;
-            }
-        }
+bool isNotEmpty(const Utilities::SmartStringView& token) {
+    return !token.isEmpty();
+}
+
+// Parses "Card N: winning numbers | player numbers". The line and its halves are allocated with
+// allocator, so an Arena can hand all of them back at once.
+Ticket parseTicket(const std::string& l, const Utilities::SmartString::allocator_type& allocator) {
+    const Utilities::SmartString line(l, allocator);
+    const auto colon = line.view().findSubstring(":");
+    const auto bar = line.view().findSubstring("|");
+    Utilities::SmartString winningText = line.getSubstring(colon + 1, bar - 1);
+    Utilities::SmartString playerText = line.getSubstring(bar + 1, line.length() - 1);
+    auto winningNumbers = winningText.strip().tokens() | std::views::filter(isNotEmpty);
+    auto playerNumbers = playerText.strip().tokens() | std::views::filter(isNotEmpty);
+
+    Ticket currentTicket;
+
+    for(auto number : winningNumbers) {
+        addNumber(currentTicket.winningNumbers, number.convert<int>());
     }
 
-    int totalTickets = 0;
-    for(const auto& ticket : tickets) {
-        totalTickets += ticketMap[ticket.cardNumber];
+    for(auto number : playerNumbers) {
+        addNumber(currentTicket.playerNumbers, number.convert<int>());
     }
 
-    std::cout << totalTickets << std::endl;
+    return currentTicket;
+}
+
+int main() {
+    std::ifstream input_file("/mnt/c/Users/Matt/CLionProjects/advent_of_code_2023/Day_04/input_data/input.txt");
+    std::string   l;
+    // cards are counted as they are parsed, so no card is kept once its line is done
+    CopyCounter copies;
+    // every line's strings come from this buffer, which is reused once the line is parsed
+    std::array<std::byte, 1024> lineBuffer{};
+    Utilities::SmartString::Arena arena(lineBuffer);
+    while(std::getline(input_file, l))
+    {
+        copies.addCard(parseTicket(l, arena.getAllocator()).getNumberOfWinningNumbers());
+        arena.release();
+    }
+    input_file.close();
+
+    std::cout << copies.getTotal() << std::endl;
 
     return 0;
 }
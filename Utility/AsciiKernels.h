@@ -0,0 +1,497 @@
+//
+// Bulk ASCII transforms used by SmartString, with SSE2/AVX2 paths picked at runtime.
+//
+
+#ifndef UTILITYCODE_ASCIIKERNELS_H
+#define UTILITYCODE_ASCIIKERNELS_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define UTILITYCODE_ASCII_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+
+namespace Utilities
+{
+    /*!
+     * @brief ASCII character classes. They are bit flags, so they can be combined with |,
+     *        e.g. AsciiClass::Upper | AsciiClass::Digit.
+     */
+    enum class AsciiClass : uint8_t
+    {
+        None         = 0,
+        Digit        = 1 << 0,
+        Upper        = 1 << 1,
+        Lower        = 1 << 2,
+        Whitespace   = 1 << 3,
+        Punctuation  = 1 << 4,
+        Alpha        = Upper | Lower,
+        Alphanumeric = Alpha | Digit
+    };
+
+    constexpr AsciiClass operator|(const AsciiClass lhs, const AsciiClass rhs)
+    {
+        return static_cast<AsciiClass>(static_cast<uint8_t>(lhs) | static_cast<uint8_t>(rhs));
+    }
+
+    constexpr bool hasAnyOf(const AsciiClass classes, const AsciiClass flags)
+    {
+        return (static_cast<uint8_t>(classes) & static_cast<uint8_t>(flags)) != 0;
+    }
+
+    /*!
+     * @brief Byte-at-a-time kernels over ASCII text. On x86-64 each kernel uses AVX2 when the
+     *        running CPU supports it and SSE2 otherwise; elsewhere the scalar loop is used.
+     *        Bytes outside of ASCII are never changed and never belong to a class.
+     */
+    class AsciiKernels
+    {
+    public:
+        enum class InstructionSet
+        {
+            Scalar,
+            SSE2,
+            AVX2
+        };
+
+        using TranslationTable = std::array<char, 256>;
+
+    private:
+        struct Range
+        {
+            unsigned char low;
+            unsigned char high;
+        };
+
+        struct RangeList
+        {
+            std::array<Range, 9> ranges{};
+            size_t size = 0;
+
+            constexpr void add(const unsigned char low, const unsigned char high)
+            {
+                ranges[size++] = {low, high};
+            }
+        };
+
+        static constexpr RangeList rangesOf(const AsciiClass classes)
+        {
+            RangeList result;
+            if(hasAnyOf(classes, AsciiClass::Digit)) result.add('0', '9');
+            if(hasAnyOf(classes, AsciiClass::Upper)) result.add('A', 'Z');
+            if(hasAnyOf(classes, AsciiClass::Lower)) result.add('a', 'z');
+            if(hasAnyOf(classes, AsciiClass::Whitespace))
+            {
+                result.add('\t', '\r');
+                result.add(' ', ' ');
+            }
+            if(hasAnyOf(classes, AsciiClass::Punctuation))
+            {
+                // everything printable that is neither a letter, a digit nor a space
+                result.add('!', '/');
+                result.add(':', '@');
+                result.add('[', '`');
+                result.add('{', '~');
+            }
+            return result;
+        }
+
+        static constexpr std::array<uint8_t, 256> createClassTable()
+        {
+            std::array<uint8_t, 256> table{};
+            const AsciiClass singleClasses[] = {AsciiClass::Digit, AsciiClass::Upper, AsciiClass::Lower,
+                                                AsciiClass::Whitespace, AsciiClass::Punctuation};
+            for(const auto singleClass : singleClasses)
+            {
+                const RangeList list = rangesOf(singleClass);
+                for(size_t i = 0; i < list.size; i++)
+                {
+                    for(unsigned int c = list.ranges[i].low; c <= list.ranges[i].high; c++)
+                    {
+                        table[c] |= static_cast<uint8_t>(singleClass);
+                    }
+                }
+            }
+            return table;
+        }
+
+        static inline bool isInClass(const char c, const AsciiClass classes)
+        {
+            static constexpr std::array<uint8_t, 256> classTable = createClassTable();
+            return (classTable[static_cast<unsigned char>(c)] & static_cast<uint8_t>(classes)) != 0;
+        }
+
+        static void shiftRangeScalar(char* data, const size_t begin, const size_t length, const Range range, const char delta)
+        {
+            for(size_t i = begin; i < length; i++)
+            {
+                if(static_cast<unsigned char>(data[i] - range.low) <= range.high - range.low)
+                {
+                    data[i] = static_cast<char>(data[i] + delta);
+                }
+            }
+        }
+
+#if defined(UTILITYCODE_ASCII_KERNELS_X86)
+        // Byte lanes of the result are all ones where low <= byte <= high (unsigned).
+        static inline __m128i inRange(const __m128i bytes, const Range range)
+        {
+            const __m128i offset = _mm_sub_epi8(bytes, _mm_set1_epi8(static_cast<char>(range.low)));
+            return _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(static_cast<char>(range.high - range.low))), offset);
+        }
+
+        static inline unsigned int classMask16(const char* block, const RangeList& list)
+        {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+            __m128i matches     = _mm_setzero_si128();
+            for(size_t i = 0; i < list.size; i++)
+            {
+                matches = _mm_or_si128(matches, inRange(bytes, list.ranges[i]));
+            }
+            return static_cast<unsigned int>(_mm_movemask_epi8(matches));
+        }
+
+        __attribute__((target("avx2")))
+        static inline __m256i inRange(const __m256i bytes, const Range range)
+        {
+            const __m256i offset = _mm256_sub_epi8(bytes, _mm256_set1_epi8(static_cast<char>(range.low)));
+            return _mm256_cmpeq_epi8(_mm256_min_epu8(offset, _mm256_set1_epi8(static_cast<char>(range.high - range.low))), offset);
+        }
+
+        __attribute__((target("avx2")))
+        static inline uint32_t classMask32(const char* block, const RangeList& list)
+        {
+            const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+            __m256i matches     = _mm256_setzero_si256();
+            for(size_t i = 0; i < list.size; i++)
+            {
+                matches = _mm256_or_si256(matches, inRange(bytes, list.ranges[i]));
+            }
+            return static_cast<uint32_t>(_mm256_movemask_epi8(matches));
+        }
+
+        static size_t shiftRangeSSE2(char* data, const size_t length, const Range range, const char delta)
+        {
+            size_t i = 0;
+            for(; i + 16 <= length; i += 16)
+            {
+                auto* block         = reinterpret_cast<__m128i*>(data + i);
+                const __m128i bytes = _mm_loadu_si128(block);
+                _mm_storeu_si128(block, _mm_add_epi8(bytes, _mm_and_si128(inRange(bytes, range), _mm_set1_epi8(delta))));
+            }
+            return i;
+        }
+
+        __attribute__((target("avx2")))
+        static size_t shiftRangeAVX2(char* data, const size_t length, const Range range, const char delta)
+        {
+            size_t i = 0;
+            for(; i + 32 <= length; i += 32)
+            {
+                auto* block         = reinterpret_cast<__m256i*>(data + i);
+                const __m256i bytes = _mm256_loadu_si256(block);
+                _mm256_storeu_si256(block, _mm256_add_epi8(bytes, _mm256_and_si256(inRange(bytes, range), _mm256_set1_epi8(delta))));
+            }
+            return i;
+        }
+
+        static size_t classMaskSSE2(const char* data, const size_t length, const RangeList& list, uint64_t* words)
+        {
+            size_t i = 0;
+            for(; i + 16 <= length; i += 16)
+            {
+                words[i / 64] |= static_cast<uint64_t>(classMask16(data + i, list)) << (i % 64);
+            }
+            return i;
+        }
+
+        __attribute__((target("avx2")))
+        static size_t classMaskAVX2(const char* data, const size_t length, const RangeList& list, uint64_t* words)
+        {
+            size_t i = 0;
+            for(; i + 32 <= length; i += 32)
+            {
+                words[i / 64] |= static_cast<uint64_t>(classMask32(data + i, list)) << (i % 64);
+            }
+            return i;
+        }
+
+        // Index of the first byte in list, or length if there is none. Only whole blocks are scanned.
+        static size_t findFirstSSE2(const char* data, const size_t length, const RangeList& list, size_t& done)
+        {
+            for(done = 0; done + 16 <= length; done += 16)
+            {
+                const unsigned int mask = classMask16(data + done, list);
+                if(mask != 0)
+                {
+                    return done + __builtin_ctz(mask);
+                }
+            }
+            return length;
+        }
+
+        // Index of the last byte in list, or length if there is none. Scans whole blocks back from
+        // the end; remaining is left at the number of unscanned bytes at the front.
+        static size_t findLastSSE2(const char* data, const size_t length, const RangeList& list, size_t& remaining)
+        {
+            for(remaining = length; remaining >= 16; remaining -= 16)
+            {
+                const unsigned int mask = classMask16(data + remaining - 16, list);
+                if(mask != 0)
+                {
+                    return remaining - 16 + (31 - __builtin_clz(mask));
+                }
+            }
+            return length;
+        }
+
+        static size_t extractSSE2(const char* data, const size_t length, const RangeList& list, char* out, size_t& written)
+        {
+            size_t i = 0;
+            for(; i + 16 <= length; i += 16)
+            {
+                unsigned int mask = classMask16(data + i, list);
+                if(mask == 0xFFFFu)
+                {
+                    std::copy_n(data + i, 16, out + written);
+                    written += 16;
+                    continue;
+                }
+                for(; mask != 0; mask &= mask - 1)
+                {
+                    out[written++] = data[i + __builtin_ctz(mask)];
+                }
+            }
+            return i;
+        }
+
+        __attribute__((target("avx2")))
+        static size_t extractAVX2(const char* data, const size_t length, const RangeList& list, char* out, size_t& written)
+        {
+            size_t i = 0;
+            for(; i + 32 <= length; i += 32)
+            {
+                uint32_t mask = classMask32(data + i, list);
+                if(mask == 0xFFFFFFFFu)
+                {
+                    std::copy_n(data + i, 32, out + written);
+                    written += 32;
+                    continue;
+                }
+                for(; mask != 0; mask &= mask - 1)
+                {
+                    out[written++] = data[i + __builtin_ctz(mask)];
+                }
+            }
+            return i;
+        }
+#endif
+
+        static void shiftRange(char* data, const size_t length, const Range range, const char delta)
+        {
+            size_t done = 0;
+#if defined(UTILITYCODE_ASCII_KERNELS_X86)
+            switch(instructionSet())
+            {
+                case InstructionSet::AVX2: done = shiftRangeAVX2(data, length, range, delta); break;
+                case InstructionSet::SSE2: done = shiftRangeSSE2(data, length, range, delta); break;
+                default: break;
+            }
+#endif
+            shiftRangeScalar(data, done, length, range, delta);
+        }
+
+        static InstructionSet detectInstructionSet()
+        {
+#if defined(UTILITYCODE_ASCII_KERNELS_X86)
+            static const InstructionSet detected = __builtin_cpu_supports("avx2") ? InstructionSet::AVX2 : InstructionSet::SSE2;
+            return detected;
+#else
+            return InstructionSet::Scalar;
+#endif
+        }
+
+        static InstructionSet& activeInstructionSet()
+        {
+            static InstructionSet active = detectInstructionSet();
+            return active;
+        }
+
+    public:
+        /*!
+         * @brief The widest instruction set the kernels will use, detected once from the CPU
+         *        unless lowered by limitInstructionSet().
+         */
+        static InstructionSet instructionSet()
+        {
+            return activeInstructionSet();
+        }
+
+        /*!
+         * @brief Keeps the kernels from using anything wider than \p widest, e.g. to run the SSE2
+         *        or scalar paths on an AVX2 CPU when testing or benchmarking them. Not thread safe,
+         *        so call it before the kernels are in use.
+         */
+        static void limitInstructionSet(const InstructionSet widest)
+        {
+            activeInstructionSet() = std::min(widest, detectInstructionSet());
+        }
+
+        static inline void toUpper(char* data, const size_t length)
+        {
+            shiftRange(data, length, {'a', 'z'}, static_cast<char>('A' - 'a'));
+        }
+
+        static inline void toLower(char* data, const size_t length)
+        {
+            shiftRange(data, length, {'A', 'Z'}, static_cast<char>('a' - 'A'));
+        }
+
+        /*!
+         * @brief Marks which bytes of \p data belong to any of \p classes.
+         * @return A bitmap where bit (i % 64) of word (i / 64) is set when data[i] is in \p classes.
+         */
+        static std::vector<uint64_t> classMask(const char* data, const size_t length, const AsciiClass classes)
+        {
+            std::vector<uint64_t> words((length + 63) / 64, 0);
+            const RangeList list = rangesOf(classes);
+            size_t done = 0;
+#if defined(UTILITYCODE_ASCII_KERNELS_X86)
+            switch(instructionSet())
+            {
+                case InstructionSet::AVX2: done = classMaskAVX2(data, length, list, words.data()); break;
+                case InstructionSet::SSE2: done = classMaskSSE2(data, length, list, words.data()); break;
+                default: break;
+            }
+#endif
+            for(size_t i = done; i < length; i++)
+            {
+                words[i / 64] |= static_cast<uint64_t>(isInClass(data[i], classes)) << (i % 64);
+            }
+            return words;
+        }
+
+        /*!
+         * @brief Finds the first byte of \p data that belongs to any of \p classes, 16 bytes at a
+         *        time. Uses SSE2 rather than AVX2 since a match is usually only a few bytes in.
+         * @return The index of the byte, or \p length if there is none.
+         */
+        static size_t findFirst(const char* data, const size_t length, const AsciiClass classes)
+        {
+            size_t done = 0;
+#if defined(UTILITYCODE_ASCII_KERNELS_X86)
+            if(instructionSet() != InstructionSet::Scalar)
+            {
+                const size_t found = findFirstSSE2(data, length, rangesOf(classes), done);
+                if(found != length)
+                {
+                    return found;
+                }
+            }
+#endif
+            for(size_t i = done; i < length; i++)
+            {
+                if(isInClass(data[i], classes))
+                {
+                    return i;
+                }
+            }
+            return length;
+        }
+
+        /*!
+         * @brief Finds the last byte of \p data that belongs to any of \p classes, scanning back
+         *        from the end 16 bytes at a time.
+         * @return The index of the byte, or \p length if there is none.
+         */
+        static size_t findLast(const char* data, const size_t length, const AsciiClass classes)
+        {
+            size_t remaining = length;
+#if defined(UTILITYCODE_ASCII_KERNELS_X86)
+            if(instructionSet() != InstructionSet::Scalar)
+            {
+                const size_t found = findLastSSE2(data, length, rangesOf(classes), remaining);
+                if(found != length)
+                {
+                    return found;
+                }
+            }
+#endif
+            for(size_t i = remaining; i > 0; i--)
+            {
+                if(isInClass(data[i - 1], classes))
+                {
+                    return i - 1;
+                }
+            }
+            return length;
+        }
+
+        /*!
+         * @brief Copies the bytes of \p data that belong to any of \p classes to \p out, in order.
+         * @param out - Must have room for \p length bytes. May not overlap \p data.
+         * @return The number of bytes written.
+         */
+        static size_t extract(const char* data, const size_t length, const AsciiClass classes, char* out)
+        {
+            const RangeList list = rangesOf(classes);
+            size_t written = 0;
+            size_t done    = 0;
+#if defined(UTILITYCODE_ASCII_KERNELS_X86)
+            switch(instructionSet())
+            {
+                case InstructionSet::AVX2: done = extractAVX2(data, length, list, out, written); break;
+                case InstructionSet::SSE2: done = extractSSE2(data, length, list, out, written); break;
+                default: break;
+            }
+#endif
+            for(size_t i = done; i < length; i++)
+            {
+                if(isInClass(data[i], classes))
+                {
+                    out[written++] = data[i];
+                }
+            }
+            return written;
+        }
+
+        /*!
+         * @brief Replaces every byte b of \p data with table[b]. A 256-entry lookup does not gain
+         *        from SSE2/AVX2 (they have no byte shuffle wider than 16 entries), so this stays scalar.
+         */
+        static void translate(char* data, const size_t length, const TranslationTable& table)
+        {
+            for(size_t i = 0; i < length; i++)
+            {
+                data[i] = table[static_cast<unsigned char>(data[i])];
+            }
+        }
+
+        /*!
+         * @brief Creates a table mapping from[i] to to[i] and every other byte to itself.
+         *        Only the first min(from.length(), to.length()) characters are used.
+         */
+        static constexpr TranslationTable createTranslationTable(const std::string_view from, const std::string_view to)
+        {
+            TranslationTable table{};
+            for(size_t c = 0; c < table.size(); c++)
+            {
+                table[c] = static_cast<char>(c);
+            }
+            for(size_t i = 0; i < from.length() && i < to.length(); i++)
+            {
+                table[static_cast<unsigned char>(from[i])] = to[i];
+            }
+            return table;
+        }
+    };
+}// namespace Utilities
+
+#endif//UTILITYCODE_ASCIIKERNELS_H
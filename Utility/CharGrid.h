@@ -0,0 +1,91 @@
+//
+// Reading character grids from text, either whole into a Grid2D or streamed through a three-row
+// window.
+//
+
+#ifndef UTILITYCODE_CHARGRID_H
+#define UTILITYCODE_CHARGRID_H
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <fstream>
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Grid2D.h"
+
+
+namespace Utilities
+{
+    /*!
+     * @brief Reads the next line of \p input into \p line without its trailing whitespace.
+     * @return false once there are no more lines, in which case \p line is empty.
+     */
+    inline bool readTrimmedLine(std::istream& input, std::string& line)
+    {
+        const bool ok = static_cast<bool>(std::getline(input, line));
+        if(!ok)
+        {
+            line.clear();
+        }
+        while(!line.empty() && std::isspace(static_cast<unsigned char>(line.back())))
+        {
+            line.pop_back();
+        }
+        return ok;
+    }
+
+    /*!
+     * @brief Reads the file at \p path into a grid one line per row. Short lines are padded with
+     *        \p padding up to the longest line.
+     */
+    inline Grid2D<char> readCharGrid(const char* path, const char padding)
+    {
+        std::ifstream input_file(path);
+        std::vector<std::string> lines;
+        std::string line;
+        std::size_t width = 0;
+        while(readTrimmedLine(input_file, line))
+        {
+            width = std::max(width, line.length());
+            lines.push_back(std::move(line));
+        }
+        Grid2D<char> grid(width, lines.size(), padding);
+        for(std::size_t y = 0; y < lines.size(); y++)
+        {
+            std::copy(lines[y].begin(), lines[y].end(), grid.row(y).begin());
+        }
+        return grid;
+    }
+
+    /*!
+     * @brief The rows above, at and below the one being resolved while a grid is streamed. Rows
+     *        above the first and below the last are empty, and cells past the end of a row read
+     *        as the padding character.
+     */
+    struct RowWindow
+    {
+        std::array<std::string, 3> rows{};
+        char padding;
+
+        explicit RowWindow(const char padding) : padding{padding} { }
+
+        [[nodiscard]] char at(const std::size_t row, const long long x) const
+        {
+            return x >= 0 && static_cast<std::size_t>(x) < rows[row].length() ? rows[row][x] : padding;
+        }
+
+        // drops the top row and makes next the bottom one
+        void push(std::string next)
+        {
+            std::rotate(rows.begin(), rows.begin() + 1, rows.end());
+            rows[2] = std::move(next);
+        }
+    };
+}// namespace Utilities
+
+#endif//UTILITYCODE_CHARGRID_H
@@ -0,0 +1,154 @@
+//
+// 256-bit membership set of bytes, used by the SmartString strip family.
+//
+
+#ifndef UTILITYCODE_CHARACTERSET_H
+#define UTILITYCODE_CHARACTERSET_H
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+namespace Utilities
+{
+    /*!
+     * @brief A set of bytes stored as a 256-bit bitmap, so membership is a shift and a mask.
+     *        Sets with only a few members (whitespace, a single padding character) also keep
+     *        the members themselves, which lets long runs of padding be skipped 16 bytes at a
+     *        time with SSE2.
+     */
+    class CharacterSet
+    {
+    private:
+        constexpr static size_t MAX_SIMD_MEMBERS = 8;
+        constexpr static size_t BLOCK_SIZE       = 16;
+
+        std::array<uint64_t, 4> bits{};
+        std::array<char, MAX_SIMD_MEMBERS> members{};
+        size_t numMembers = 0;
+
+        [[nodiscard]] constexpr bool isSimdFriendly() const
+        {
+            return numMembers <= MAX_SIMD_MEMBERS;
+        }
+
+#if defined(__SSE2__)
+        // Bit i of the result is set when byte i of the block is in the set.
+        [[nodiscard]] unsigned int blockMask(const char* block) const
+        {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+            __m128i matches     = _mm_setzero_si128();
+            for(size_t i = 0; i < numMembers; i++)
+            {
+                matches = _mm_or_si128(matches, _mm_cmpeq_epi8(bytes, _mm_set1_epi8(members[i])));
+            }
+            return static_cast<unsigned int>(_mm_movemask_epi8(matches));
+        }
+#endif
+
+    public:
+        constexpr CharacterSet() = default;
+
+        constexpr explicit CharacterSet(const std::string_view characters)
+        {
+            for(const char c : characters)
+            {
+                add(c);
+            }
+        }
+
+        constexpr CharacterSet& add(const char c)
+        {
+            if(contains(c))
+            {
+                return *this;
+            }
+            const auto byte = static_cast<unsigned char>(c);
+            bits[byte >> 6] |= uint64_t{1} << (byte & 63);
+            if(numMembers < MAX_SIMD_MEMBERS)
+            {
+                members[numMembers] = c;
+            }
+            numMembers++;
+            return *this;
+        }
+
+        [[nodiscard]] constexpr bool contains(const char c) const
+        {
+            const auto byte = static_cast<unsigned char>(c);
+            return (bits[byte >> 6] >> (byte & 63)) & 1;
+        }
+
+        [[nodiscard]] constexpr size_t size() const
+        {
+            return numMembers;
+        }
+
+        /*!
+         * @brief Counts how many characters at the start of \p text are in this set.
+         */
+        [[nodiscard]] size_t countLeading(const std::string_view text) const
+        {
+            size_t index = 0;
+#if defined(__SSE2__)
+            if(isSimdFriendly())
+            {
+                for(; index + BLOCK_SIZE <= text.length(); index += BLOCK_SIZE)
+                {
+                    const unsigned int outside = ~blockMask(text.data() + index) & 0xFFFFu;
+                    if(outside != 0)
+                    {
+                        return index + std::countr_zero(outside);
+                    }
+                }
+            }
+#endif
+            while(index < text.length() && contains(text[index]))
+            {
+                index++;
+            }
+            return index;
+        }
+
+        /*!
+         * @brief Counts how many characters at the end of \p text are in this set.
+         */
+        [[nodiscard]] size_t countTrailing(const std::string_view text) const
+        {
+            size_t remaining = text.length();
+#if defined(__SSE2__)
+            if(isSimdFriendly())
+            {
+                for(; remaining >= BLOCK_SIZE; remaining -= BLOCK_SIZE)
+                {
+                    const unsigned int outside = ~blockMask(text.data() + remaining - BLOCK_SIZE) & 0xFFFFu;
+                    if(outside != 0)
+                    {
+                        // the highest set bit is the last character that is not in the set
+                        return text.length() - remaining + std::countl_zero(outside) - 16;
+                    }
+                }
+            }
+#endif
+            while(remaining > 0 && contains(text[remaining - 1]))
+            {
+                remaining--;
+            }
+            return text.length() - remaining;
+        }
+
+        [[nodiscard]] static constexpr CharacterSet whitespace()
+        {
+            return CharacterSet(" \t\n\r\x0b\x0c");
+        }
+    };
+}// namespace Utilities
+
+#endif//UTILITYCODE_CHARACTERSET_H
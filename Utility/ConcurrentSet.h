@@ -0,0 +1,167 @@
+//
+// Set that several threads can add to and query at once.
+//
+
+#ifndef UTILITYCODE_CONCURRENTSET_H
+#define UTILITYCODE_CONCURRENTSET_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Set.h"
+
+namespace Utilities
+{
+    /*!
+     * @brief A set split into shards, each a regular Set behind its own reader/writer lock. An item
+     *        always lives in the shard picked by its hash, so threads working on different items
+     *        rarely wait for each other and lookups only take a shared lock. Use snapshot() to get
+     *        an ordinary Set once ingestion is done.
+     * @tparam T - The item type. Must have a std::hash specialisation.
+     * @tparam Policy - The storage policy of each shard, as for Set.
+     */
+    template <typename T, typename Policy = DefaultSetPolicy<T>>
+    class ConcurrentSet
+    {
+        static_assert(is_hashable<T>::value, "ConcurrentSet needs a std::hash specialisation for T to pick shards");
+
+    private:
+        // Each shard gets its own cache line so locking one does not slow down its neighbours.
+        struct alignas(64) Shard
+        {
+            mutable std::shared_mutex mutex;
+            Set<T, Policy> items;
+        };
+
+        std::unique_ptr<Shard[]> shards;
+        size_t numShards;
+        unsigned int shardShift;
+
+        static size_t defaultShardCount()
+        {
+            // a few shards per core keeps the chance of two threads meeting on one lock low
+            return 4 * std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        // The splitmix64 finaliser, so the shard does not correlate with where a hashed shard's
+        // own table puts the item.
+        static uint64_t mix(uint64_t hash)
+        {
+            hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+            hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+            return hash ^ (hash >> 31);
+        }
+
+        Shard& shardOf(const T& item) const
+        {
+            const uint64_t hash = mix(static_cast<uint64_t>(std::hash<T>{}(item)));
+            return shards[shardShift == 64 ? 0 : static_cast<size_t>(hash >> shardShift)];
+        }
+
+    public:
+        /*!
+         * @param requestedShards - Rounded up to a power of two. Defaults to four per hardware thread.
+         */
+        explicit ConcurrentSet(const size_t requestedShards = defaultShardCount())
+            : numShards{std::bit_ceil(std::max<size_t>(1, requestedShards))},
+              shardShift{static_cast<unsigned int>(64 - std::countr_zero(numShards))}
+        {
+            shards = std::make_unique<Shard[]>(numShards);
+        }
+
+        ConcurrentSet(const ConcurrentSet&)            = delete;
+        ConcurrentSet& operator=(const ConcurrentSet&) = delete;
+
+        bool addItem(const T& item)
+        {
+            Shard& shard = shardOf(item);
+            std::unique_lock lock(shard.mutex);
+            return shard.items.addItem(item);
+        }
+
+        bool addItem(T&& item)
+        {
+            Shard& shard = shardOf(item);
+            std::unique_lock lock(shard.mutex);
+            return shard.items.addItem(std::move(item));
+        }
+
+        bool contains(const T& item) const
+        {
+            const Shard& shard = shardOf(item);
+            std::shared_lock lock(shard.mutex);
+            return shard.items.contains(item);
+        }
+
+        bool removeItem(const T& item)
+        {
+            Shard& shard = shardOf(item);
+            std::unique_lock lock(shard.mutex);
+            return shard.items.removeItem(item);
+        }
+
+        // The same as removeItem.
+        bool removeValue(const T& item)
+        {
+            return removeItem(item);
+        }
+
+        /*!
+         * @brief The number of items. While other threads are changing the set this is only a
+         *        momentary estimate, since each shard is counted under its own lock.
+         */
+        int size() const
+        {
+            int total = 0;
+            for(size_t i = 0; i < numShards; i++)
+            {
+                std::shared_lock lock(shards[i].mutex);
+                total += shards[i].items.size();
+            }
+            return total;
+        }
+
+        size_t getNumShards() const
+        {
+            return numShards;
+        }
+
+        /*!
+         * @brief Copies every item into a regular Set. All shards are read-locked together (always
+         *        in the same order, so two snapshots cannot deadlock) while their items are copied
+         *        out, so the copy is a consistent picture of the set at one moment. The Set is then
+         *        built once from all of them, with a single sort under SortedSetPolicy.
+         */
+        Set<T, Policy> snapshot() const
+        {
+            std::vector<T> all;
+            {
+                std::vector<std::shared_lock<std::shared_mutex>> locks;
+                locks.reserve(numShards);
+                size_t total = 0;
+                for(size_t i = 0; i < numShards; i++)
+                {
+                    locks.emplace_back(shards[i].mutex);
+                    total += static_cast<size_t>(shards[i].items.size());
+                }
+                all.reserve(total);
+                for(size_t i = 0; i < numShards; i++)
+                {
+                    all.insert(all.end(), shards[i].items.begin(), shards[i].items.end());
+                }
+            }
+            return Set<T, Policy>(std::move(all));
+        }
+    };
+}// namespace Utilities
+
+#endif//UTILITYCODE_CONCURRENTSET_H
@@ -0,0 +1,188 @@
+//
+// Fixed-size two dimensional grid with flat row-major storage.
+//
+
+#ifndef UTILITYCODE_GRID2D_H
+#define UTILITYCODE_GRID2D_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace Utilities
+{
+    /*!
+     * @brief The cells a grid neighbourhood walk visits: the 4 orthogonal neighbours, or all 8
+     *        including the diagonals.
+     */
+    enum class Neighbourhood
+    {
+        Orthogonal,
+        All
+    };
+
+    /*!
+     * @brief A width x height grid stored as one row-major vector, so a row is contiguous and
+     *        cell (x, y) lives at index y * width + x. x is the column and y the row.
+     * @tparam T - The cell type.
+     */
+    template <typename T>
+    class Grid2D
+    {
+    private:
+        struct Offset
+        {
+            int dx;
+            int dy;
+        };
+
+        // The orthogonal neighbours come first, so an Orthogonal walk is a prefix of an All walk.
+        constexpr static std::array<Offset, 8> NEIGHBOUR_OFFSETS{{
+            {0, -1}, {-1, 0}, {1, 0}, {0, 1},
+            {-1, -1}, {1, -1}, {-1, 1}, {1, 1}
+        }};
+
+        std::size_t width  = 0;
+        std::size_t height = 0;
+        std::vector<T> cells;
+
+        [[nodiscard]] inline std::size_t indexOf(const std::size_t x, const std::size_t y) const
+        {
+            return y * width + x;
+        }
+
+        void checkBounds(const std::size_t x, const std::size_t y) const
+        {
+            if(x >= width || y >= height)
+            {
+                throw std::out_of_range("Cell (" + std::to_string(x) + ", " + std::to_string(y) + ") is outside a " +
+                                        std::to_string(width) + "x" + std::to_string(height) + " grid");
+            }
+        }
+
+    public:
+        Grid2D() = default;
+
+        Grid2D(const std::size_t width, const std::size_t height, const T& initialValue = T{})
+            : width{width}, height{height}, cells(width * height, initialValue)
+        {
+        }
+
+        [[nodiscard]] inline std::size_t getWidth() const
+        {
+            return width;
+        }
+
+        [[nodiscard]] inline std::size_t getHeight() const
+        {
+            return height;
+        }
+
+        [[nodiscard]] inline std::size_t size() const
+        {
+            return cells.size();
+        }
+
+        /*!
+         * @brief Whether (x, y) is a cell of this grid. Takes signed coordinates so that
+         *        neighbours of edge cells can be tested directly.
+         */
+        [[nodiscard]] inline bool isInBounds(const long long x, const long long y) const
+        {
+            return x >= 0 && y >= 0 && static_cast<std::size_t>(x) < width && static_cast<std::size_t>(y) < height;
+        }
+
+        // unchecked access
+        inline T& operator()(const std::size_t x, const std::size_t y)
+        {
+            return cells[indexOf(x, y)];
+        }
+
+        inline const T& operator()(const std::size_t x, const std::size_t y) const
+        {
+            return cells[indexOf(x, y)];
+        }
+
+        // checked access
+        T& at(const std::size_t x, const std::size_t y)
+        {
+            checkBounds(x, y);
+            return cells[indexOf(x, y)];
+        }
+
+        const T& at(const std::size_t x, const std::size_t y) const
+        {
+            checkBounds(x, y);
+            return cells[indexOf(x, y)];
+        }
+
+        [[nodiscard]] inline std::span<T> row(const std::size_t y)
+        {
+            return std::span<T>(cells).subspan(y * width, width);
+        }
+
+        [[nodiscard]] inline std::span<const T> row(const std::size_t y) const
+        {
+            return std::span<const T>(cells).subspan(y * width, width);
+        }
+
+        [[nodiscard]] inline std::span<T> data()
+        {
+            return cells;
+        }
+
+        [[nodiscard]] inline std::span<const T> data() const
+        {
+            return cells;
+        }
+
+        void fill(const T& value)
+        {
+            std::fill(cells.begin(), cells.end(), value);
+        }
+
+        /*!
+         * @brief Calls \p visitor(nx, ny, cell) for each neighbour of (x, y) that lies inside the
+         *        grid. Edge and corner cells simply have fewer neighbours.
+         */
+        template <typename F>
+        void forEachNeighbour(const std::size_t x, const std::size_t y, F&& visitor,
+                              const Neighbourhood neighbourhood = Neighbourhood::All)
+        {
+            const std::size_t count = neighbourhood == Neighbourhood::All ? 8 : 4;
+            for(std::size_t i = 0; i < count; i++)
+            {
+                const long long nx = static_cast<long long>(x) + NEIGHBOUR_OFFSETS[i].dx;
+                const long long ny = static_cast<long long>(y) + NEIGHBOUR_OFFSETS[i].dy;
+                if(isInBounds(nx, ny))
+                {
+                    visitor(static_cast<std::size_t>(nx), static_cast<std::size_t>(ny), (*this)(nx, ny));
+                }
+            }
+        }
+
+        template <typename F>
+        void forEachNeighbour(const std::size_t x, const std::size_t y, F&& visitor,
+                              const Neighbourhood neighbourhood = Neighbourhood::All) const
+        {
+            const std::size_t count = neighbourhood == Neighbourhood::All ? 8 : 4;
+            for(std::size_t i = 0; i < count; i++)
+            {
+                const long long nx = static_cast<long long>(x) + NEIGHBOUR_OFFSETS[i].dx;
+                const long long ny = static_cast<long long>(y) + NEIGHBOUR_OFFSETS[i].dy;
+                if(isInBounds(nx, ny))
+                {
+                    visitor(static_cast<std::size_t>(nx), static_cast<std::size_t>(ny), (*this)(nx, ny));
+                }
+            }
+        }
+    };
+}// namespace Utilities
+
+#endif//UTILITYCODE_GRID2D_H
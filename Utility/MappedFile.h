@@ -0,0 +1,132 @@
+//
+// Read-only view of a whole file, memory-mapped where the platform supports it.
+//
+
+#ifndef UTILITYCODE_MAPPEDFILE_H
+#define UTILITYCODE_MAPPEDFILE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define UTILITYCODE_MAPPEDFILE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace Utilities
+{
+    /*!
+     * @brief The contents of a file as one contiguous, read-only buffer. On POSIX systems the file
+     *        is memory-mapped, so pages are only read in as they are touched and several threads can
+     *        share them; elsewhere the file is read into memory in one go.
+     */
+    class MappedFile
+    {
+    private:
+        const char* data = nullptr;
+        std::size_t size = 0;
+#if defined(UTILITYCODE_MAPPEDFILE_MMAP)
+        void* mapping = nullptr;
+#endif
+        std::string fallback;
+
+        void readWhole(const std::string& path)
+        {
+            std::ifstream file(path, std::ios::binary);
+            if(!file)
+            {
+                throw std::runtime_error("Could not open " + path);
+            }
+            std::ostringstream contents;
+            contents << file.rdbuf();
+            fallback = std::move(contents).str();
+            data     = fallback.data();
+            size     = fallback.size();
+        }
+
+    public:
+        explicit MappedFile(const std::string& path)
+        {
+#if defined(UTILITYCODE_MAPPEDFILE_MMAP)
+            const int descriptor = ::open(path.c_str(), O_RDONLY);
+            if(descriptor < 0)
+            {
+                throw std::runtime_error("Could not open " + path);
+            }
+            struct stat status{};
+            if(::fstat(descriptor, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0)
+            {
+                void* mapped = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+                if(mapped != MAP_FAILED)
+                {
+                    mapping = mapped;
+                    data    = static_cast<const char*>(mapped);
+                    size    = static_cast<std::size_t>(status.st_size);
+                    ::madvise(mapped, size, MADV_SEQUENTIAL);
+                }
+            }
+            ::close(descriptor);
+            if(mapping != nullptr || (status.st_size == 0 && S_ISREG(status.st_mode)))
+            {
+                return;
+            }
+#endif
+            // pipes, special files and platforms without mmap
+            readWhole(path);
+        }
+
+        MappedFile(const MappedFile&)            = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        ~MappedFile()
+        {
+#if defined(UTILITYCODE_MAPPEDFILE_MMAP)
+            if(mapping != nullptr)
+            {
+                ::munmap(mapping, size);
+            }
+#endif
+        }
+
+        [[nodiscard]] inline std::string_view view() const
+        {
+            return {data, size};
+        }
+
+        /*!
+         * @brief Splits the file into at most \p numChunks pieces of roughly equal size, each ending
+         *        just after a newline (or at the end of the file), so no line is split between two
+         *        chunks. Fewer chunks are returned when the file has fewer lines.
+         */
+        [[nodiscard]] std::vector<std::string_view> splitLines(const std::size_t numChunks) const
+        {
+            std::vector<std::string_view> chunks;
+            std::size_t start = 0;
+            for(std::size_t chunk = 1; chunk <= numChunks && start < size; chunk++)
+            {
+                std::size_t end = chunk == numChunks ? size : std::max(start, size / numChunks * chunk);
+                if(end < size)
+                {
+                    const auto* newline = static_cast<const char*>(std::memchr(data + end, '\n', size - end));
+                    end = newline == nullptr ? size : static_cast<std::size_t>(newline - data) + 1;
+                }
+                chunks.emplace_back(data + start, end - start);
+                start = end;
+            }
+            return chunks;
+        }
+    };
+}// namespace Utilities
+
+#endif//UTILITYCODE_MAPPEDFILE_H
@@ -0,0 +1,287 @@
+//
+// Aho-Corasick automaton for finding many patterns in one pass over a string.
+//
+
+#ifndef UTILITYCODE_MULTIPATTERNMATCHER_H
+#define UTILITYCODE_MULTIPATTERNMATCHER_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <queue>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+namespace Utilities
+{
+    /*!
+     * @brief Finds every occurrence of a fixed set of patterns, overlapping ones included, in a
+     *        single O(n) pass. The patterns are compiled once into an Aho-Corasick automaton whose
+     *        failure links are folded into a dense transition table, so each character costs one
+     *        table lookup. Bytes that appear in no pattern share a single column of the table,
+     *        which keeps it small for the usual case of a short alphabet.
+     *
+     *        A Backward matcher is built from the reversed patterns and walks the text from its
+     *        end, so findFirst() on it finds the match that ends last. Match positions are always
+     *        reported in terms of the original text.
+     */
+    class MultiPatternMatcher
+    {
+    public:
+        enum class Direction
+        {
+            Forward,
+            Backward
+        };
+
+        struct Match
+        {
+            // Index of the first character of the match in the searched text.
+            std::size_t position;
+            std::size_t length;
+            // Index of the matched pattern in the list the matcher was built from.
+            std::size_t patternIndex;
+
+            bool operator==(const Match&) const = default;
+        };
+
+    private:
+        using State = uint32_t;
+
+        constexpr static State ROOT = 0;
+
+        Direction direction;
+        std::vector<std::size_t> patternLengths;
+        std::size_t maxPatternLength = 0;
+
+        // Maps each byte to its column in the transition table. Column 0 is every byte that
+        // appears in no pattern.
+        std::array<uint16_t, 256> columnOf{};
+        std::size_t numColumns = 1;
+        std::vector<State> transitions;
+
+        // The patterns recognised in each state (its own plus those reached through failure
+        // links), flattened: state s owns outputs[outputStart[s] .. outputStart[s + 1]).
+        std::vector<std::size_t> outputStart;
+        std::vector<uint32_t> outputs;
+
+        [[nodiscard]] inline State next(const State state, const char c) const
+        {
+            return transitions[state * numColumns + columnOf[static_cast<unsigned char>(c)]];
+        }
+
+        [[nodiscard]] inline char characterAt(const std::string_view text, const std::size_t step) const
+        {
+            return direction == Direction::Forward ? text[step] : text[text.length() - 1 - step];
+        }
+
+        // Converts "pattern ends after step characters of the scan" into a position in the text.
+        [[nodiscard]] inline Match makeMatch(const std::string_view text, const std::size_t step, const uint32_t pattern) const
+        {
+            const std::size_t length = patternLengths[pattern];
+            const std::size_t position = direction == Direction::Forward ? step + 1 - length : text.length() - 1 - step;
+            return {position, length, pattern};
+        }
+
+        void build(const std::vector<std::string>& patterns)
+        {
+            for(const std::string& pattern : patterns)
+            {
+                if(pattern.empty())
+                {
+                    throw std::invalid_argument("A MultiPatternMatcher needs non-empty patterns");
+                }
+                for(const char c : pattern)
+                {
+                    auto& column = columnOf[static_cast<unsigned char>(c)];
+                    if(column == 0)
+                    {
+                        column = static_cast<uint16_t>(numColumns++);
+                    }
+                }
+            }
+
+            // The trie, with 0 meaning "no edge" (the root is never a child).
+            std::vector<std::vector<uint32_t>> ownOutputs(1);
+            transitions.assign(numColumns, ROOT);
+            for(uint32_t index = 0; index < patterns.size(); index++)
+            {
+                State state = ROOT;
+                for(const char c : patterns[index])
+                {
+                    const std::size_t slot = state * numColumns + columnOf[static_cast<unsigned char>(c)];
+                    if(transitions[slot] == ROOT)
+                    {
+                        transitions[slot] = static_cast<State>(ownOutputs.size());
+                        ownOutputs.emplace_back();
+                        transitions.resize(transitions.size() + numColumns, ROOT);
+                    }
+                    state = transitions[slot];
+                }
+                ownOutputs[state].push_back(index);
+            }
+
+            // Breadth first, so every state's failure target is finished before the state itself.
+            // Missing edges are filled in from the failure target, turning the trie into a DFA.
+            const std::size_t numStates = ownOutputs.size();
+            std::vector<State> failure(numStates, ROOT);
+            std::vector<std::vector<uint32_t>> allOutputs(numStates);
+            std::queue<State> pending;
+            for(std::size_t column = 0; column < numColumns; column++)
+            {
+                if(transitions[column] != ROOT)
+                {
+                    pending.push(transitions[column]);
+                }
+            }
+            while(!pending.empty())
+            {
+                const State state = pending.front();
+                pending.pop();
+
+                allOutputs[state] = ownOutputs[state];
+                const auto& inherited = allOutputs[failure[state]];
+                allOutputs[state].insert(allOutputs[state].end(), inherited.begin(), inherited.end());
+
+                for(std::size_t column = 0; column < numColumns; column++)
+                {
+                    State& target = transitions[state * numColumns + column];
+                    const State fallback = transitions[failure[state] * numColumns + column];
+                    if(target == ROOT)
+                    {
+                        target = fallback;
+                    }
+                    else
+                    {
+                        failure[target] = fallback;
+                        pending.push(target);
+                    }
+                }
+            }
+
+            outputStart.reserve(numStates + 1);
+            for(const auto& stateOutputs : allOutputs)
+            {
+                outputStart.push_back(outputs.size());
+                outputs.insert(outputs.end(), stateOutputs.begin(), stateOutputs.end());
+            }
+            outputStart.push_back(outputs.size());
+        }
+
+        /*
+         * Runs the automaton over text, calling onMatch for each match as it completes. onMatch
+         * returns false to stop the scan early.
+         */
+        template <typename F>
+        void scan(const std::string_view text, F&& onMatch) const
+        {
+            State state = ROOT;
+            for(std::size_t step = 0; step < text.length(); step++)
+            {
+                state = next(state, characterAt(text, step));
+                for(std::size_t output = outputStart[state]; output < outputStart[state + 1]; output++)
+                {
+                    if(!onMatch(step, outputs[output]))
+                    {
+                        return;
+                    }
+                }
+            }
+        }
+
+    public:
+        template <std::ranges::input_range R>
+        explicit MultiPatternMatcher(const R& patterns, const Direction direction = Direction::Forward)
+            : direction{direction}
+        {
+            std::vector<std::string> compiled;
+            for(const auto& pattern : patterns)
+            {
+                std::string text{std::string_view(pattern)};
+                if(direction == Direction::Backward)
+                {
+                    text.assign(text.rbegin(), text.rend());
+                }
+                maxPatternLength = std::max(maxPatternLength, text.length());
+                patternLengths.push_back(text.length());
+                compiled.push_back(std::move(text));
+            }
+            build(compiled);
+        }
+
+        MultiPatternMatcher(const std::initializer_list<std::string_view> patterns, const Direction direction = Direction::Forward)
+            : MultiPatternMatcher(std::vector<std::string_view>(patterns), direction)
+        {
+        }
+
+        [[nodiscard]] inline Direction getDirection() const
+        {
+            return direction;
+        }
+
+        [[nodiscard]] inline std::size_t getNumPatterns() const
+        {
+            return patternLengths.size();
+        }
+
+        /*!
+         * @brief Calls \p onMatch with every match in \p text, in the order the scan completes them.
+         */
+        template <typename F>
+        void forEachMatch(const std::string_view text, F&& onMatch) const
+        {
+            scan(text, [&](const std::size_t step, const uint32_t pattern) {
+                onMatch(makeMatch(text, step, pattern));
+                return true;
+            });
+        }
+
+        /*!
+         * @brief Every match in \p text, overlapping ones included, in the order the scan completes them.
+         */
+        [[nodiscard]] std::vector<Match> findAll(const std::string_view text) const
+        {
+            std::vector<Match> matches;
+            forEachMatch(text, [&matches](const Match& match) { matches.push_back(match); });
+            return matches;
+        }
+
+        /*!
+         * @brief The match that starts first in the scan direction: the leftmost match for a Forward
+         *        matcher, the one ending last for a Backward matcher. Ties go to the shorter pattern.
+         *        The scan stops as soon as no later match could start earlier.
+         */
+        [[nodiscard]] std::optional<Match> findFirst(const std::string_view text) const
+        {
+            std::optional<std::size_t> bestStart;
+            std::size_t bestStep = 0;
+            uint32_t bestPattern = 0;
+            scan(text, [&](const std::size_t step, const uint32_t pattern) {
+                const std::size_t start = step + 1 - patternLengths[pattern];
+                if(!bestStart || start < *bestStart || (start == *bestStart && step < bestStep))
+                {
+                    bestStart = start;
+                    bestStep = step;
+                    bestPattern = pattern;
+                }
+                // any match completing later than this starts after the best one
+                return step + 1 < *bestStart + maxPatternLength;
+            });
+            if(!bestStart)
+            {
+                return std::nullopt;
+            }
+            return makeMatch(text, bestStep, bestPattern);
+        }
+    };
+}// namespace Utilities
+
+#endif//UTILITYCODE_MULTIPATTERNMATCHER_H
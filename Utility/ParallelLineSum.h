@@ -0,0 +1,145 @@
+//
+// Sums a value over every line of a file on several threads, for puzzles whose answer is such a sum.
+//
+
+#ifndef UTILITYCODE_PARALLELLINESUM_H
+#define UTILITYCODE_PARALLELLINESUM_H
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "MappedFile.h"
+
+
+namespace Utilities
+{
+    struct LineSumOptions
+    {
+        unsigned int threads = 1;
+        bool verbose = false;
+    };
+
+    /*!
+     * @brief Reads --threads N, which splits the input across N workers, and --verbose, which echoes
+     *        every line with its value.
+     * @return Nothing when an argument is not one of those, or --threads is missing its count or
+     *         the count is not a whole number >= 1.
+     */
+    inline std::optional<LineSumOptions> parseLineSumOptions(const int argc, char** argv)
+    {
+        LineSumOptions options;
+        for(int i = 1; i < argc; i++)
+        {
+            const std::string_view argument(argv[i]);
+            if(argument == "--threads")
+            {
+                if(i + 1 == argc)
+                {
+                    return std::nullopt;
+                }
+                const std::string_view count(argv[++i]);
+                const auto [end, error] = std::from_chars(count.data(), count.data() + count.size(), options.threads);
+                if(error != std::errc() || end != count.data() + count.size() || options.threads < 1)
+                {
+                    return std::nullopt;
+                }
+            }
+            else if(argument == "--verbose")
+            {
+                options.verbose = true;
+            }
+            else
+            {
+                return std::nullopt;
+            }
+        }
+        return options;
+    }
+
+    inline void printLineSumUsage(std::ostream& out, const char* program)
+    {
+        out << "usage: " << program << " [--threads N] [--verbose]  (N is a whole number >= 1)" << std::endl;
+    }
+
+    /*!
+     * @brief The sum of \p lineValue over the lines of \p chunk, echoing each line and its value to
+     *        \p echo unless it is null.
+     */
+    template <typename LineValue>
+    long long sumLines(const std::string_view chunk, const LineValue& lineValue, std::ostream* echo)
+    {
+        long long sum = 0;
+        const char* lineStart = chunk.data();
+        const char* const chunkEnd = chunk.data() + chunk.size();
+        while(lineStart < chunkEnd)
+        {
+            const auto* newline = static_cast<const char*>(std::memchr(lineStart, '\n', chunkEnd - lineStart));
+            const char* lineEnd = newline == nullptr ? chunkEnd : newline;
+            const std::string_view line(lineStart, lineEnd - lineStart);
+            const auto val = lineValue(line);
+            if(echo != nullptr)
+            {
+                *echo << line << " -> " << val << '\n';
+            }
+            sum += val;
+            lineStart = lineEnd + 1;
+        }
+        return sum;
+    }
+
+    /*!
+     * @brief Parses the command line with parseLineSumOptions, then prints the sum of \p lineValue
+     *        over every line of the file at \p path. Each worker sums one chunk of whole lines, so
+     *        the partial sums add up to the single-threaded sum, and --verbose echoes are printed in
+     *        file order once all workers are done.
+     * @param lineValue - Callable taking a line as a std::string_view, without its newline, and
+     *                    returning its integer value. Called from several threads at once.
+     * @return The exit status for main: 1 after printing the usage message if the arguments are bad.
+     */
+    template <typename LineValue>
+    int printLineSum(const int argc, char** argv, const std::string& path, const LineValue& lineValue)
+    {
+        const std::optional<LineSumOptions> parsed = parseLineSumOptions(argc, argv);
+        if(!parsed)
+        {
+            printLineSumUsage(std::cerr, argv[0]);
+            return 1;
+        }
+        const LineSumOptions& options = *parsed;
+        const MappedFile input(path);
+
+        const std::vector<std::string_view> chunks = input.splitLines(options.threads);
+        std::vector<long long> partials(chunks.size(), 0);
+        std::vector<std::ostringstream> echoes(options.verbose ? chunks.size() : 0);
+        {
+            std::vector<std::jthread> workers;
+            for(std::size_t i = 1; i < chunks.size(); i++)
+            {
+                workers.emplace_back([&, i] { partials[i] = sumLines(chunks[i], lineValue, options.verbose ? &echoes[i] : nullptr); });
+            }
+            if(!chunks.empty())
+            {
+                partials[0] = sumLines(chunks[0], lineValue, options.verbose ? &echoes[0] : nullptr);
+            }
+        }
+        for(const auto& echo : echoes)
+        {
+            std::cout << echo.view();
+        }
+        std::cout << std::endl << std::accumulate(partials.begin(), partials.end(), 0LL) << std::endl;
+        return 0;
+    }
+}// namespace Utilities
+
+#endif//UTILITYCODE_PARALLELLINESUM_H
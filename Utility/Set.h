@@ -6,8 +6,25 @@
 #define UTILITYCODE_SET_H
 
 #include <vector>
+#include <algorithm>
 #include <iterator> // For std::forward_iterator_tag
 #include <cstddef>  // For std::ptrdiff_t
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <array>
+#include <concepts>
+#include <stdexcept>
+#include <string>
+#include <span>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define UTILITYCODE_SET_X86 1
+#include <immintrin.h>
+#endif
 
 namespace Utilities
 {
@@ -19,70 +36,545 @@ namespace Utilities
     decltype(std::declval<T &>() == std::declval<T &>()), bool>{}>::type>
     : std::true_type { };
 
-    template <typename T>
-    class Set
+    template<typename T, typename = void>
+    struct is_less_comparable : std::false_type { };
+
+    template<typename T>
+    struct is_less_comparable<T, typename std::enable_if<std::is_convertible<
+    decltype(std::declval<const T &>() < std::declval<const T &>()), bool>{}>::type>
+    : std::true_type { };
+
+    template<typename T, typename = void>
+    struct is_hashable : std::false_type { };
+
+    template<typename T>
+    struct is_hashable<T, typename std::enable_if<std::is_convertible<
+    decltype(std::declval<std::hash<T>>()(std::declval<const T &>())), size_t>{}>::type>
+    : std::true_type { };
+
+    /*!
+     * @brief Items are kept in a vector and found by comparing each one with ==. Works for any
+     *        type, but lookups are O(n).
+     */
+    struct LinearSetPolicy { };
+
+    /*!
+     * @brief Items are kept in a vector and indexed by an open addressing (Robin Hood) hash table,
+     *        so lookups are O(1) on average. Needs std::hash<T>.
+     */
+    struct HashedSetPolicy { };
+
+    /*!
+     * @brief Items are kept sorted in a vector, so lookups are binary searches and Union,
+     *        Intersection, Complement and isSubSetOf are linear merges. Inserting or removing one
+     *        item shifts the ones after it, so this suits sets that are read far more often than
+     *        they are changed. Needs operator< on T.
+     */
+    struct SortedSetPolicy { };
+
+    /*!
+     * @brief Items are integers in [0, Max), stored as one bit each in uint64_t words. Membership is
+     *        a bit test, the set algebra is word-wise OR/AND/XOR and size() is a popcount.
+     */
+    template<size_t Max>
+    struct BitsetPolicy { };
+
+    // Unsigned integer types of at most 8 bits have few enough values to always use a bitset.
+    template<typename T>
+    constexpr bool is_small_unsigned_integral = std::is_integral<T>::value && std::is_unsigned<T>::value &&
+                                                std::numeric_limits<T>::digits <= 8;
+
+    // A bitset for small integer types, then hashing where possible, then a plain linear scan.
+    // SortedSetPolicy changes the item order and relies on operator< agreeing with ==, so it is
+    // only used when asked for.
+    template<typename T>
+    using DefaultSetPolicy = typename std::conditional<is_small_unsigned_integral<T>, BitsetPolicy<size_t{1} << std::numeric_limits<T>::digits>,
+                             typename std::conditional<is_hashable<T>::value, HashedSetPolicy, LinearSetPolicy>::type>::type;
+
+    /*!
+     * @brief The storage behind a Set. Every policy keeps the items densely in a vector, so they
+     *        can be indexed. The unordered policies remove an item by moving the last one into the
+     *        gap, so removal does not preserve the order of the remaining items.
+     */
+    template<typename T, typename Policy>
+    class SetStorage;
+
+    template<typename T>
+    class SetStorage<T, LinearSetPolicy>
     {
-        static_assert(is_equal_comparable<T>::value, "Type T must be comparable with the == operator");
+    private:
+        std::vector<T> items;
+
+    public:
+        int indexOf(const T& item) const
+        {
+            for(size_t i = 0; i < items.size(); i++)
+            {
+                if(items[i] == item)
+                {
+                    return static_cast<int>(i);
+                }
+            }
+            return -1;
+        }
+
+        // the caller guarantees item is not already stored
+        template<typename U>
+        void append(U&& item)
+        {
+            items.push_back(std::forward<U>(item));
+        }
+
+        void eraseAt(const size_t index)
+        {
+            if(index + 1 != items.size())
+            {
+                items[index] = std::move(items.back());
+            }
+            items.pop_back();
+        }
+
+        void reserve(const size_t capacity)
+        {
+            items.reserve(capacity);
+        }
+
+        const std::vector<T>& getItems() const
+        {
+            return items;
+        }
+    };
 
+    template<typename T>
+    class SetStorage<T, HashedSetPolicy>
+    {
     private:
+        using Slot = uint32_t;
+
+        constexpr static Slot EMPTY = std::numeric_limits<Slot>::max();
+        constexpr static size_t MIN_CAPACITY = 8;
+        // Fibonacci hashing: the top bits of hash * 2^64/phi pick the home slot, which spreads
+        // out keys whose std::hash is the identity.
+        constexpr static uint64_t HASH_MULTIPLIER = 0x9E3779B97F4A7C15ull;
+
         std::vector<T> items;
+        // hashes[i] is the mixed hash of items[i], kept so probing and rehashing never rehash items
+        std::vector<uint64_t> hashes;
+        // each slot holds an index into items, or EMPTY
+        std::vector<Slot> slots;
+        unsigned int shift = 64;
+
+        static uint64_t hashOf(const T& item)
+        {
+            return static_cast<uint64_t>(std::hash<T>{}(item)) * HASH_MULTIPLIER;
+        }
+
+        size_t mask() const
+        {
+            return slots.size() - 1;
+        }
 
-        void forceAdd(const T& item)
+        size_t homeOf(const uint64_t hash) const
         {
-            items.push_back(item);
+            return static_cast<size_t>(hash >> shift);
+        }
+
+        // how far the item in slot position has been displaced from its home slot
+        size_t distanceAt(const size_t position) const
+        {
+            return (position - homeOf(hashes[slots[position]])) & mask();
+        }
+
+        // Robin Hood insertion: an item travelling further than a resident takes its slot and the
+        // resident moves on, which keeps probe lengths short and lets lookups stop early.
+        void place(Slot index)
+        {
+            size_t position = homeOf(hashes[index]);
+            size_t distance = 0;
+            while(slots[position] != EMPTY)
+            {
+                const size_t residentDistance = distanceAt(position);
+                if(residentDistance < distance)
+                {
+                    std::swap(index, slots[position]);
+                    distance = residentDistance;
+                }
+                position = (position + 1) & mask();
+                distance++;
+            }
+            slots[position] = index;
+        }
+
+        size_t slotOf(const Slot index) const
+        {
+            size_t position = homeOf(hashes[index]);
+            while(slots[position] != index)
+            {
+                position = (position + 1) & mask();
+            }
+            return position;
+        }
+
+        // the most items slotCount slots hold before the table grows (a 7/8 load factor)
+        static size_t capacityOf(const size_t slotCount)
+        {
+            return slotCount - slotCount / 8;
+        }
+
+        void rehash(const size_t capacity)
+        {
+            size_t newSize = std::max(MIN_CAPACITY, slots.size());
+            while(capacityOf(newSize) < capacity)
+            {
+                newSize *= 2;
+            }
+            if(newSize <= slots.size())
+            {
+                return;
+            }
+            slots.assign(newSize, EMPTY);
+            shift = 64 - std::countr_zero(newSize);
+            for(size_t i = 0; i < items.size(); i++)
+            {
+                place(static_cast<Slot>(i));
+            }
         }
 
     public:
+        int indexOf(const T& item) const
+        {
+            if(items.empty())
+            {
+                return -1;
+            }
+            const uint64_t hash = hashOf(item);
+            size_t position = homeOf(hash);
+            for(size_t distance = 0; slots[position] != EMPTY && distanceAt(position) >= distance; distance++)
+            {
+                const Slot index = slots[position];
+                if(hashes[index] == hash && items[index] == item)
+                {
+                    return static_cast<int>(index);
+                }
+                position = (position + 1) & mask();
+            }
+            return -1;
+        }
 
-        Set() : items(std::vector<T>()) {}
-        Set(const T* list, int size)
+        // the caller guarantees item is not already stored
+        template<typename U>
+        void append(U&& item)
         {
-            items = std::vector<T>();
-            for(int i = 0; i < size; i++)
+            if(items.size() + 1 > capacityOf(slots.size()))
             {
-                addItem(list[i]);
+                rehash(items.size() + 1);
             }
+            items.push_back(std::forward<U>(item));
+            hashes.push_back(hashOf(items.back()));
+            place(static_cast<Slot>(items.size() - 1));
         }
-        explicit Set(const std::vector<T>& list)
+
+        void eraseAt(const size_t index)
+        {
+            // backward shift deletion: pull the following displaced items one slot closer to home
+            size_t position = slotOf(static_cast<Slot>(index));
+            size_t next     = (position + 1) & mask();
+            while(slots[next] != EMPTY && distanceAt(next) > 0)
+            {
+                slots[position] = slots[next];
+                position        = next;
+                next            = (next + 1) & mask();
+            }
+            slots[position] = EMPTY;
+
+            const size_t last = items.size() - 1;
+            if(index != last)
+            {
+                slots[slotOf(static_cast<Slot>(last))] = static_cast<Slot>(index);
+                items[index]  = std::move(items[last]);
+                hashes[index] = hashes[last];
+            }
+            items.pop_back();
+            hashes.pop_back();
+        }
+
+        void reserve(const size_t capacity)
+        {
+            items.reserve(capacity);
+            hashes.reserve(capacity);
+            rehash(capacity);
+        }
+
+        const std::vector<T>& getItems() const
+        {
+            return items;
+        }
+    };
+
+    template<typename T>
+    class SetStorage<T, SortedSetPolicy>
+    {
+    private:
+        std::vector<T> items;
+
+    public:
+        int indexOf(const T& item) const
+        {
+            const auto found = std::lower_bound(items.begin(), items.end(), item);
+            return found != items.end() && *found == item ? static_cast<int>(found - items.begin()) : -1;
+        }
+
+        // the caller guarantees item is not already stored
+        template<typename U>
+        void append(U&& item)
+        {
+            const auto position = std::lower_bound(items.begin(), items.end(), item);
+            items.insert(position, std::forward<U>(item));
+        }
+
+        void eraseAt(const size_t index)
         {
-            items = std::vector<T>();
-            for(int i = 0; i < list.size(); i++)
+            items.erase(items.begin() + index);
+        }
+
+        void reserve(const size_t capacity)
+        {
+            items.reserve(capacity);
+        }
+
+        // replaces the contents with sorted, which must be in ascending order with no duplicates
+        void assignSorted(std::vector<T>&& sorted)
+        {
+            items = std::move(sorted);
+        }
+
+        // Adds the items of other (sorted, no duplicates) that are missing. Room for all of other is
+        // reserved once, the missing items are appended in order and the two sorted runs merged.
+        void unionWith(const std::vector<T>& other)
+        {
+            items.reserve(items.size() + other.size());
+            const size_t originalSize = items.size();
+            for(size_t i = 0, j = 0; j < other.size(); j++)
+            {
+                while(i < originalSize && items[i] < other[j])
+                {
+                    i++;
+                }
+                if(i == originalSize || !(items[i] == other[j]))
+                {
+                    items.push_back(other[j]);
+                }
+            }
+            std::inplace_merge(items.begin(), items.begin() + originalSize, items.end());
+        }
+
+        // Keeps only the items that are (or, with keepShared false, are not) in other, compacting
+        // them towards the front in one merge pass.
+        void retain(const std::vector<T>& other, const bool keepShared)
+        {
+            size_t kept = 0;
+            for(size_t i = 0, j = 0; i < items.size(); i++)
             {
-                addItem(list[i]);
+                while(j < other.size() && other[j] < items[i])
+                {
+                    j++;
+                }
+                const bool shared = j < other.size() && other[j] == items[i];
+                if(shared == keepShared)
+                {
+                    if(kept != i)
+                    {
+                        items[kept] = std::move(items[i]);
+                    }
+                    kept++;
+                }
             }
+            items.erase(items.begin() + kept, items.end());
         }
-        Set(const Set<T>& set)
+
+        // Keeps only the items in exactly one of this and other (sorted, no duplicates). Room for
+        // both is reserved once, shared items are compacted out and other's new items appended in
+        // one merge pass, then the two sorted runs are merged.
+        void symmetricDifferenceWith(const std::vector<T>& other)
         {
-            items = std::vector<T>();
-            for(int i = 0; i < set.items.size(); i++)
+            items.reserve(items.size() + other.size());
+            const size_t originalSize = items.size();
+            size_t kept = 0;
+            size_t j = 0;
+            for(size_t i = 0; i < originalSize; i++)
             {
-                items.push_back(set.items[i]);
+                while(j < other.size() && other[j] < items[i])
+                {
+                    items.push_back(other[j++]);
+                }
+                if(j < other.size() && other[j] == items[i])
+                {
+                    j++;
+                    continue;
+                }
+                if(kept != i)
+                {
+                    items[kept] = std::move(items[i]);
+                }
+                kept++;
             }
+            items.insert(items.end(), other.begin() + j, other.end());
+            items.erase(items.begin() + kept, items.begin() + originalSize);
+            std::inplace_merge(items.begin(), items.begin() + kept, items.end());
+        }
+
+        const std::vector<T>& getItems() const
+        {
+            return items;
+        }
+    };
+
+    /*!
+     * @brief An unordered collection of distinct items. How items are stored and found is chosen
+     *        by Policy: by default hashed for types with a std::hash, otherwise a linear scan using ==.
+     *        SortedSetPolicy must be requested explicitly; with it, operator[] visits the items in
+     *        ascending order.
+     */
+    template <typename T, typename Policy = DefaultSetPolicy<T>>
+    class Set
+    {
+        static_assert(is_equal_comparable<T>::value, "Type T must be comparable with the == operator");
+        static_assert(!std::is_same<Policy, HashedSetPolicy>::value || is_hashable<T>::value,
+                      "HashedSetPolicy needs a std::hash specialisation for T");
+        static_assert(!std::is_same<Policy, SortedSetPolicy>::value || is_less_comparable<T>::value,
+                      "SortedSetPolicy needs T to be comparable with the < operator");
+
+    private:
+        constexpr static bool IS_SORTED = std::is_same<Policy, SortedSetPolicy>::value;
+
+        SetStorage<T, Policy> items;
+
+        // The two sets' items merged by mergeAlgorithm (std::set_union and friends) into a new set.
+        template<typename MergeAlgorithm>
+        static Set<T, Policy> merge(const Set<T, Policy>& lhs, const Set<T, Policy>& rhs, const size_t capacity, MergeAlgorithm mergeAlgorithm)
+        {
+            const std::vector<T>& left  = lhs.items.getItems();
+            const std::vector<T>& right = rhs.items.getItems();
+            std::vector<T> merged;
+            merged.reserve(capacity);
+            mergeAlgorithm(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(merged));
+            Set<T, Policy> result;
+            result.items.assignSorted(std::move(merged));
+            return result;
+        }
+
+        // sorts list and drops its duplicates in place, then takes it over as the sorted items
+        void assignUnsorted(std::vector<T>&& list)
+        {
+            std::sort(list.begin(), list.end());
+            list.erase(std::unique(list.begin(), list.end()), list.end());
+            items.assignSorted(std::move(list));
+        }
+
+        void assignFrom(const T* list, const size_t size)
+        {
+            if constexpr(IS_SORTED)
+            {
+                assignUnsorted(std::vector<T>(list, list + size));
+            }
+            else
+            {
+                items.reserve(size);
+                for(size_t i = 0; i < size; i++)
+                {
+                    addItem(list[i]);
+                }
+            }
+        }
+
+        template<typename U>
+        void forceAdd(U&& item)
+        {
+            items.append(std::forward<U>(item));
         }
-        ~Set() = default;
 
-        Set<T>& operator=(const Set<T>& set)
+        // Removes the items that are (or, with removeShared false, are not) in other. Walks from the
+        // back so the item moved into a freed index has already been visited.
+        void removeWhere(const Set<T, Policy>& other, const bool removeShared)
         {
-            if(this != &set)
+            for(int i = size() - 1; i >= 0; i--)
             {
-                items = std::vector<T>(set.items);
+                if(other.contains((*this)[i]) == removeShared)
+                {
+                    items.eraseAt(i);
+                }
             }
         }
 
+    public:
+
+        Set() = default;
+        Set(const T* list, int size)
+        {
+            assignFrom(list, size);
+        }
+        explicit Set(const std::vector<T>& list)
+        {
+            assignFrom(list.data(), list.size());
+        }
+        // With SortedSetPolicy, list is sorted in place and kept rather than copied.
+        explicit Set(std::vector<T>&& list)
+        {
+            if constexpr(IS_SORTED)
+            {
+                assignUnsorted(std::move(list));
+            }
+            else
+            {
+                assignFrom(list.data(), list.size());
+            }
+        }
+        Set(const Set<T, Policy>& set) = default;
+        Set(Set<T, Policy>&& set) noexcept = default;
+        ~Set() = default;
+
+        Set<T, Policy>& operator=(const Set<T, Policy>& set) = default;
+        Set<T, Policy>& operator=(Set<T, Policy>&& set) noexcept = default;
+
+        using const_iterator = typename std::vector<T>::const_iterator;
+        using iterator       = const_iterator;
+
         T operator[](const int index) const
         {
-            return items[index];
+            return items.getItems()[index];
+        }
+
+        // Items are read-only through iterators and view(), since changing one in place could
+        // break the set's ordering or hashing.
+        const_iterator begin() const
+        {
+            return items.getItems().begin();
+        }
+
+        const_iterator end() const
+        {
+            return items.getItems().end();
+        }
+
+        std::span<const T> view() const
+        {
+            return items.getItems();
         }
 
-        bool operator==(const Set<T>& rhs) const
+        bool operator==(const Set<T, Policy>& rhs) const
         {
             if(size() != rhs.size())
             {
                 return false;
             }
+            if constexpr(IS_SORTED)
+            {
+                return items.getItems() == rhs.items.getItems();
+            }
+            // neither set holds duplicates, so equal sizes and one-way containment are enough
             for(int i = 0; i < size(); i++)
             {
-                if(!contains(rhs[i]) || !contains(items[i]))
+                if(!contains(rhs[i]))
                 {
                     return false;
                 }
@@ -92,14 +584,7 @@ namespace Utilities
 
         int getIndexOf(const T& item) const
         {
-            for(int i = 0; i < size(); i++)
-            {
-                if(items[i] == item)
-                {
-                    return i;
-                }
-            }
-            return -1;
+            return items.indexOf(item);
         }
 
         bool contains(const T& item) const
@@ -114,63 +599,155 @@ namespace Utilities
             {
                 return false;
             }
-            items.push_back(item);
+            items.append(item);
             return true;
         }
 
-        bool addItem(const T&& item)
+        bool addItem(T&& item)
         {
             int index = getIndexOf(item);
             if(index >= 0)
             {
                 return false;
             }
-            items.push_back(item);
+            items.append(std::move(item));
             return true;
         }
 
+        // Constructs the item from args and moves it in if it is not already present.
+        template<typename... Args>
+        bool emplace(Args&&... args)
+        {
+            return addItem(T(std::forward<Args>(args)...));
+        }
+
+        void reserve(const int capacity)
+        {
+            items.reserve(capacity);
+        }
+
         bool removeItem(const T& item)
         {
-            return removeItem(getIndexOf(item));
+            return removeAt(getIndexOf(item));
+        }
+
+        // The same as removeItem.
+        bool removeValue(const T& item)
+        {
+            return removeItem(item);
         }
 
-        bool removeItem(const int index)
+        // The only way to remove by index, so removeItem(n) always means the item n even when T is
+        // integral. Except with SortedSetPolicy, this moves the last item into the freed index, so
+        // the order of the remaining items changes.
+        bool removeAt(const int index)
         {
-            if(index < 0 || index >= items.size())
+            if(index < 0 || index >= size())
             {
                 return false;
             }
-            items.erase(items.begin() + index);
+            items.eraseAt(index);
             return true;
         }
 
         int size() const
         {
-            return items.size();
+            return items.getItems().size();
+        }
+
+        // Adds every item of other to this set, in place.
+        Set<T, Policy>& unionWith(const Set<T, Policy>& other)
+        {
+            if(this == &other)
+            {
+                return *this;
+            }
+            if constexpr(IS_SORTED)
+            {
+                items.unionWith(other.items.getItems());
+            }
+            else
+            {
+                for(const T& item : other)
+                {
+                    addItem(item);
+                }
+            }
+            return *this;
+        }
+
+        // Removes every item that is not also in other, in place.
+        Set<T, Policy>& intersectWith(const Set<T, Policy>& other)
+        {
+            if(this == &other)
+            {
+                return *this;
+            }
+            if constexpr(IS_SORTED)
+            {
+                items.retain(other.items.getItems(), true);
+            }
+            else
+            {
+                removeWhere(other, false);
+            }
+            return *this;
+        }
+
+        // Removes every item that is also in other, in place.
+        Set<T, Policy>& subtract(const Set<T, Policy>& other)
+        {
+            if(this == &other)
+            {
+                *this = Set<T, Policy>();
+                return *this;
+            }
+            if constexpr(IS_SORTED)
+            {
+                items.retain(other.items.getItems(), false);
+            }
+            else if(other.size() < size())
+            {
+                for(const T& item : other)
+                {
+                    removeItem(item);
+                }
+            }
+            else
+            {
+                removeWhere(other, true);
+            }
+            return *this;
         }
 
         //Provides the union of two sets.
         //e.g. {1, 2} U {2, 3} = {1, 2, 3}
-        Set<T> Union(const Set<T>& other) const
+        Set<T, Policy> Union(const Set<T, Policy>& other) const
         {
-            Set<T> result = *this;
-            for(int i = 0; i < other.size(); i++)
+            if constexpr(IS_SORTED)
             {
-                result.addItem(other[i]);
+                return merge(*this, other, size() + other.size(), [](auto... args) { return std::set_union(args...); });
             }
+            Set<T, Policy> result = *this;
+            result.items.reserve(size() + other.size());
+            result.unionWith(other);
             return result;
         }
 
         //provides the intersection of two sets.
         //e.g. {1, 2} I {2, 3} = {2}
-        Set<T> Intersection(const Set<T>& other) const
+        Set<T, Policy> Intersection(const Set<T, Policy>& other) const
         {
-            Set<T> result = Set<T>();
+            if constexpr(IS_SORTED)
+            {
+                return merge(*this, other, std::min(size(), other.size()), [](auto... args) { return std::set_intersection(args...); });
+            }
+            Set<T, Policy> result = Set<T, Policy>();
             for(int i = 0; i < size(); i++)
             {
-                if(other.contains(items[i]))
+                if(other.contains((*this)[i]))
                 {
-                    result.forceAdd(items[i]);
+                    result.forceAdd((*this)[i]);
                 }
             }
             return result;
@@ -179,69 +756,492 @@ namespace Utilities
         // provides the complement of the calling set
         // with regards to the set passed in.
         // e.g. {1, 2} / {2, 3} = {1, 3}
-        Set<T> Complement(const Set<T>& other) const
+        Set<T, Policy> Complement(const Set<T, Policy>& other) const
         {
-            Set<T> result = Set<T>();
+            if constexpr(IS_SORTED)
+            {
+                return merge(*this, other, size() + other.size(), [](auto... args) { return std::set_symmetric_difference(args...); });
+            }
+            Set<T, Policy> result = Set<T, Policy>();
             for(int i = 0; i < size(); i++)
             {
-                if(!other.contains(items[i]))
+                if(!other.contains((*this)[i]))
                 {
-                    result.forceAdd(items[i]);
+                    result.forceAdd((*this)[i]);
                 }
             }
             for(int i = 0; i < other.size(); i++)
             {
                 if(!contains(other[i]))
                 {
-                    result.addItem(other[i]);
+                    result.forceAdd(other[i]);
                 }
             }
             return result;
         }
 
-        Set<T> operator+(const Set<T>& other) const
+        Set<T, Policy> operator+(const Set<T, Policy>& other) const
         {
             return Union(other);
         }
 
-        Set<T> operator-(const Set<T>& other) const
+        Set<T, Policy> operator-(const Set<T, Policy>& other) const
         {
             return Complement(other);
         }
 
-        Set<T>& operator+=(const Set<T>& other)
+        Set<T, Policy>& operator+=(const Set<T, Policy>& other)
         {
-            for(int i = 0; i < other.size(); i++)
+            return unionWith(other);
+        }
+
+        // In place form of Complement.
+        Set<T, Policy>& operator-=(const Set<T, Policy>& other)
+        {
+            if(this == &other)
+            {
+                *this = Set<T, Policy>();
+            }
+            else if constexpr(IS_SORTED)
+            {
+                items.symmetricDifferenceWith(other.items.getItems());
+            }
+            else
             {
-                addItem(other[i]);
+                for(const T& item : other)
+                {
+                    if(!removeItem(item))
+                    {
+                        forceAdd(item);
+                    }
+                }
             }
             return *this;
         }
 
-        Set<T>& operator-=(const Set<T>& other)
+        bool isSubSetOf(const Set<T, Policy>& other) const
         {
-            Set<T> temp = Complement(other);
-            *this       = temp;
-            return *this;
+            if(size() > other.size())
+            {
+                return false;
+            }
+            if constexpr(IS_SORTED)
+            {
+                const std::vector<T>& otherItems = other.items.getItems();
+                return std::includes(otherItems.begin(), otherItems.end(), items.getItems().begin(), items.getItems().end());
+            }
+            for(int i = 0; i < size(); i++)
+            {
+                if(!other.contains((*this)[i]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool isSuperSetOf(const Set<T, Policy>& other) const
+        {
+            return other.isSubSetOf(*this);
+        }
+
+        [[deprecated("iterate the set or use view() instead of copying it")]]
+        std::vector<T> toVector() const
+        {
+            return items.getItems();
         }
 
-        bool isSubSetOf(const Set<T>& other) const
+        [[deprecated("iterate the set or use view() instead of copying it")]]
+        T* toArray() const
         {
+            T* result = new T[size()];
             for(int i = 0; i < size(); i++)
             {
-                if(!other.contains(items[i]))
+                result[i] = (*this)[i];
+            }
+            return result;
+        }
+    };
+
+    /*!
+     * @brief Word-wise kernels for bitset sets. They process four words per step with AVX2 when
+     *        the CPU reports it at runtime, and one word at a time otherwise.
+     */
+    class BitsetKernels
+    {
+    public:
+        enum class Operation
+        {
+            Or,
+            And,
+            Xor,
+            AndNot
+        };
+
+    private:
+        static inline uint64_t apply(const Operation operation, const uint64_t lhs, const uint64_t rhs)
+        {
+            switch(operation)
+            {
+                case Operation::Or: return lhs | rhs;
+                case Operation::And: return lhs & rhs;
+                case Operation::AndNot: return lhs & ~rhs;
+                default: return lhs ^ rhs;
+            }
+        }
+
+#if defined(UTILITYCODE_SET_X86)
+        static bool hasAVX2()
+        {
+            static const bool supported = __builtin_cpu_supports("avx2");
+            return supported;
+        }
+
+        __attribute__((target("avx2")))
+        static size_t combineAVX2(const Operation operation, uint64_t* out, const uint64_t* lhs, const uint64_t* rhs, const size_t numWords)
+        {
+            size_t i = 0;
+            for(; i + 4 <= numWords; i += 4)
+            {
+                const __m256i left  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + i));
+                const __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + i));
+                __m256i result;
+                switch(operation)
+                {
+                    case Operation::Or: result = _mm256_or_si256(left, right); break;
+                    case Operation::And: result = _mm256_and_si256(left, right); break;
+                    case Operation::AndNot: result = _mm256_andnot_si256(right, left); break;
+                    default: result = _mm256_xor_si256(left, right); break;
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), result);
+            }
+            return i;
+        }
+#endif
+
+    public:
+        // out[i] = lhs[i] op rhs[i]. out may be lhs or rhs.
+        static void combine(const Operation operation, uint64_t* out, const uint64_t* lhs, const uint64_t* rhs, const size_t numWords)
+        {
+            size_t done = 0;
+#if defined(UTILITYCODE_SET_X86)
+            if(numWords >= 4 && hasAVX2())
+            {
+                done = combineAVX2(operation, out, lhs, rhs, numWords);
+            }
+#endif
+            for(size_t i = done; i < numWords; i++)
+            {
+                out[i] = apply(operation, lhs[i], rhs[i]);
+            }
+        }
+    };
+
+    /*!
+     * @brief A Set of integers in [0, Max) stored as a bitset. The API matches the general Set;
+     *        the items are indexed in ascending order, so operator[] and getIndexOf are a select
+     *        and a rank over the words. Adding an item outside [0, Max) throws std::out_of_range.
+     */
+    template <typename T, size_t Max>
+    class Set<T, BitsetPolicy<Max>>
+    {
+        static_assert(std::is_integral<T>::value, "BitsetPolicy needs an integral item type");
+        static_assert(Max > 0, "BitsetPolicy needs a non-empty domain");
+
+    private:
+        using Self = Set<T, BitsetPolicy<Max>>;
+
+        constexpr static size_t NUM_WORDS = (Max + 63) / 64;
+
+        std::array<uint64_t, NUM_WORDS> words{};
+
+        static bool isInDomain(const T& item)
+        {
+            if constexpr(std::is_signed<T>::value)
+            {
+                if(item < 0)
                 {
                     return false;
                 }
             }
+            return static_cast<size_t>(item) < Max;
+        }
+
+        static Self combine(const BitsetKernels::Operation operation, const Self& lhs, const Self& rhs)
+        {
+            Self result;
+            BitsetKernels::combine(operation, result.words.data(), lhs.words.data(), rhs.words.data(), NUM_WORDS);
+            return result;
+        }
+
+        bool set(const T& item)
+        {
+            if(!isInDomain(item))
+            {
+                throw std::out_of_range("Set item " + std::to_string(item) + " is outside the bitset domain [0, " + std::to_string(Max) + ")");
+            }
+            uint64_t& word    = words[static_cast<size_t>(item) / 64];
+            const uint64_t bit = uint64_t{1} << (static_cast<size_t>(item) % 64);
+            const bool added  = (word & bit) == 0;
+            word |= bit;
+            return added;
+        }
+
+    public:
+        // Visits the items in ascending order, one set bit at a time.
+        class const_iterator
+        {
+        private:
+            const std::array<uint64_t, NUM_WORDS>* words = nullptr;
+            size_t wordIndex = NUM_WORDS;
+            // the bits of the current word not yet visited
+            uint64_t remaining = 0;
+
+            void skipEmptyWords()
+            {
+                while(remaining == 0 && ++wordIndex < NUM_WORDS)
+                {
+                    remaining = (*words)[wordIndex];
+                }
+            }
+
+        public:
+            // operator* returns the item by value, which the forward iterator requirements of the
+            // standard library's algorithms do not allow, so they see an input iterator.
+            using iterator_category = std::input_iterator_tag;
+            using iterator_concept  = std::forward_iterator_tag;
+            using difference_type   = std::ptrdiff_t;
+            using value_type        = T;
+            using pointer           = const T*;
+            using reference         = T;
+
+            const_iterator() = default;
+            explicit const_iterator(const std::array<uint64_t, NUM_WORDS>& bits) : words{&bits}, wordIndex{0}, remaining{bits[0]}
+            {
+                skipEmptyWords();
+            }
+
+            T operator*() const
+            {
+                return static_cast<T>(wordIndex * 64 + std::countr_zero(remaining));
+            }
+
+            const_iterator& operator++()
+            {
+                remaining &= remaining - 1;
+                skipEmptyWords();
+                return *this;
+            }
+
+            const_iterator operator++(int)
+            {
+                const_iterator previous = *this;
+                ++(*this);
+                return previous;
+            }
+
+            bool operator==(const const_iterator& other) const
+            {
+                return wordIndex == other.wordIndex && remaining == other.remaining;
+            }
+        };
+        using iterator = const_iterator;
+
+        Set() = default;
+        Set(const T* list, int size)
+        {
+            for(int i = 0; i < size; i++)
+            {
+                set(list[i]);
+            }
+        }
+        explicit Set(const std::vector<T>& list) : Set(list.data(), static_cast<int>(list.size())) {}
+        Set(const Self& set) = default;
+        Set(Self&& set) noexcept = default;
+        ~Set() = default;
+
+        Self& operator=(const Self& set) = default;
+        Self& operator=(Self&& set) noexcept = default;
+
+        // The index-th smallest item.
+        T operator[](const int index) const
+        {
+            int remaining = index;
+            for(size_t w = 0; w < NUM_WORDS; w++)
+            {
+                const int count = std::popcount(words[w]);
+                if(remaining < count)
+                {
+                    uint64_t word = words[w];
+                    for(int i = 0; i < remaining; i++)
+                    {
+                        word &= word - 1;
+                    }
+                    return static_cast<T>(w * 64 + std::countr_zero(word));
+                }
+                remaining -= count;
+            }
+            throw std::out_of_range("Set index " + std::to_string(index) + " is out of range");
+        }
+
+        const_iterator begin() const
+        {
+            return const_iterator(words);
+        }
+
+        const_iterator end() const
+        {
+            return const_iterator();
+        }
+
+        bool operator==(const Self& rhs) const
+        {
+            return words == rhs.words;
+        }
+
+        // The number of smaller items, or -1 if item is not in the set.
+        int getIndexOf(const T& item) const
+        {
+            if(!contains(item))
+            {
+                return -1;
+            }
+            const size_t bit = static_cast<size_t>(item);
+            int index = 0;
+            for(size_t w = 0; w < bit / 64; w++)
+            {
+                index += std::popcount(words[w]);
+            }
+            return index + std::popcount(words[bit / 64] & ((uint64_t{1} << (bit % 64)) - 1));
+        }
+
+        bool contains(const T& item) const
+        {
+            return isInDomain(item) && ((words[static_cast<size_t>(item) / 64] >> (static_cast<size_t>(item) % 64)) & 1) != 0;
+        }
+
+        bool addItem(const T& item)
+        {
+            return set(item);
+        }
+
+        bool addItem(T&& item)
+        {
+            return set(item);
+        }
+
+        template<typename... Args>
+        bool emplace(Args&&... args)
+        {
+            return set(T(std::forward<Args>(args)...));
+        }
+
+        // The words are allocated with the set, so there is nothing to reserve.
+        void reserve(const int)
+        {
+        }
+
+        bool removeItem(const T& item)
+        {
+            if(!contains(item))
+            {
+                return false;
+            }
+            words[static_cast<size_t>(item) / 64] &= ~(uint64_t{1} << (static_cast<size_t>(item) % 64));
             return true;
         }
 
-        bool isSuperSetOf(const Set<T>& other) const
+        bool removeAt(const int index)
         {
-            for(int i = 0; i < other.size(); i++)
+            if(index < 0 || index >= size())
             {
-                if(!contains(other[i]))
+                return false;
+            }
+            return removeItem((*this)[index]);
+        }
+
+        // The same as removeItem.
+        bool removeValue(const T& item)
+        {
+            return removeItem(item);
+        }
+
+        int size() const
+        {
+            int count = 0;
+            for(const uint64_t word : words)
+            {
+                count += std::popcount(word);
+            }
+            return count;
+        }
+
+        //Provides the union of two sets.
+        //e.g. {1, 2} U {2, 3} = {1, 2, 3}
+        Self Union(const Self& other) const
+        {
+            return combine(BitsetKernels::Operation::Or, *this, other);
+        }
+
+        //provides the intersection of two sets.
+        //e.g. {1, 2} I {2, 3} = {2}
+        Self Intersection(const Self& other) const
+        {
+            return combine(BitsetKernels::Operation::And, *this, other);
+        }
+
+        // provides the complement of the calling set
+        // with regards to the set passed in.
+        // e.g. {1, 2} / {2, 3} = {1, 3}
+        Self Complement(const Self& other) const
+        {
+            return combine(BitsetKernels::Operation::Xor, *this, other);
+        }
+
+        Self operator+(const Self& other) const
+        {
+            return Union(other);
+        }
+
+        Self operator-(const Self& other) const
+        {
+            return Complement(other);
+        }
+
+        Self& unionWith(const Self& other)
+        {
+            BitsetKernels::combine(BitsetKernels::Operation::Or, words.data(), words.data(), other.words.data(), NUM_WORDS);
+            return *this;
+        }
+
+        Self& intersectWith(const Self& other)
+        {
+            BitsetKernels::combine(BitsetKernels::Operation::And, words.data(), words.data(), other.words.data(), NUM_WORDS);
+            return *this;
+        }
+
+        Self& subtract(const Self& other)
+        {
+            BitsetKernels::combine(BitsetKernels::Operation::AndNot, words.data(), words.data(), other.words.data(), NUM_WORDS);
+            return *this;
+        }
+
+        Self& operator+=(const Self& other)
+        {
+            return unionWith(other);
+        }
+
+        Self& operator-=(const Self& other)
+        {
+            BitsetKernels::combine(BitsetKernels::Operation::Xor, words.data(), words.data(), other.words.data(), NUM_WORDS);
+            return *this;
+        }
+
+        bool isSubSetOf(const Self& other) const
+        {
+            for(size_t w = 0; w < NUM_WORDS; w++)
+            {
+                if((words[w] & ~other.words[w]) != 0)
                 {
                     return false;
                 }
@@ -249,18 +1249,22 @@ namespace Utilities
             return true;
         }
 
+        bool isSuperSetOf(const Self& other) const
+        {
+            return other.isSubSetOf(*this);
+        }
+
+        [[deprecated("iterate the set instead of copying it")]]
         std::vector<T> toVector() const
         {
-            return std::vector<T>(items);
+            return std::vector<T>(begin(), end());
         }
 
+        [[deprecated("iterate the set instead of copying it")]]
         T* toArray() const
         {
             T* result = new T[size()];
-            for(int i = 0; i < size(); i++)
-            {
-                result[i] = items[i];
-            }
+            std::copy(begin(), end(), result);
             return result;
         }
     };
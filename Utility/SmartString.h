@@ -18,7 +18,23 @@
 #include <utility>
 #include <iterator>
 #include <type_traits>
-
+#include <string_view>
+#include <bit>
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <optional>
+#include <charconv>
+#include <system_error>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "AsciiKernels.h"
+#include "CharacterSet.h"
+#include "MultiPatternMatcher.h"
+#include "SmartStringView.h"
 
 namespace Utilities
 {
@@ -35,77 +51,75 @@ namespace Utilities
 
         constexpr static int DEFAULT_PRECISION = 5;
 
-        std::string backingString;
+        std::pmr::string backingString;
         int precision;
 
-        /*!
-         * @brief Converts a single to digit to its character equivalent. This assumes
-         *        \p digit is a single digit number. Use at your own risk.
-         * @param digit - Single digit number to convert
-         * @return The character equivalent of \p digit.
-         */
-        static inline char digitToChar(const unsigned int digit)
-        {
-            return static_cast<char>(digit + static_cast<unsigned int>('0'));
-        }
+        constexpr static int ALPHABET_SIZE = 256;
 
         /*!
-         * @brief Converts a given character to its numerical equivalent. This assumes
-         *        \p c is a character between '0' and '9'. Use at your own risk.
-         * @param c - character to convert
-         * @return The numerical equivalent of \p c
+         * @brief Creates the bad character table used in the Boyer-Moore algorithms for \p targetWord.
+         *        The final character of \p targetWord is left out, which is what Horspool needs and
+         *        is equivalent for the full Boyer-Moore bad character rule.
+         * @param targetWord - The word to be searched
+         * @return A table where [c] is the index of the last occurrence of character c in
+         *         \p targetWord (excluding its final character), or -1 if there is none.
          */
-        static inline unsigned int charToDigit(const char c)
+        static std::array<int, ALPHABET_SIZE> createBoyerMooreBadCharacterTable(const std::string_view targetWord)
         {
-            return static_cast<unsigned int>(c) - static_cast<unsigned int>('0');
+            std::array<int, ALPHABET_SIZE> badCharacterTable{};
+            badCharacterTable.fill(-1);
+            for(std::string_view::size_type i = 0; i + 1 < targetWord.length(); i++)
+            {
+                badCharacterTable[static_cast<unsigned char>(targetWord[i])] = static_cast<int>(i);
+            }
+            return badCharacterTable;
         }
 
         /*!
-         * @brief Finds the number of format arguments present in the current string.
-         *        Format arguments are of the form {0}, {1}, etc.
-         * @return The number of format arguments
+         * @brief Creates the (strong) good suffix table used in the Boyer-Moore algorithm for \p targetWord.
+         * @param targetWord - The word to be searched
+         * @return A table of length targetWord.length() + 1 where [j + 1] is how far the pattern may
+         *         be shifted after a mismatch at position j.
          */
-        [[nodiscard]] int getNumArguments() const
-        {
-            std::string::size_type location;
-            int count = 0;
-            do {
-                SmartString arg;
-                arg << "{" << count << "}";
-                location = findSubstring(arg);
-                if(location != std::string::npos)
-                {
-                    count++;
-                }
-            } while(location != std::string::npos);
-            return count;
-        }
-
-        std::vector<std::vector<int>> createBoyerMooreBadCharacterTable(const SmartString& targetWord)
+        static std::vector<int> createBoyerMooreGoodSuffixTable(const std::string_view targetWord)
         {
-            static const int alphabetSize = 256;
-            std::vector<std::vector<int>> badCharacterTable(alphabetSize);
+            const auto targetLength = static_cast<int>(targetWord.length());
+            std::vector<int> shift(targetLength + 1, 0);
+            std::vector<int> border(targetLength + 1, 0);
 
-            for(int i = 0; i < alphabetSize; i++)
+            // shifts for suffixes that reoccur elsewhere in the word
+            int i = targetLength;
+            int j = targetLength + 1;
+            border[i] = j;
+            while(i > 0)
             {
-                badCharacterTable[i].assign(targetWord.length(), -1);
-            }
-
-            for(int i = 0; i < targetWord.length(); i++)
-            {
-                int previouslyEncounteredCharacterIndex = -1;
-                for(int j = i - 1; j >= 0; j--)
+                while(j <= targetLength && targetWord[i - 1] != targetWord[j - 1])
                 {
-                    if(targetWord[i] == targetWord[j])
+                    if(shift[j] == 0)
                     {
-                        previouslyEncounteredCharacterIndex = j;
-                        break;
+                        shift[j] = j - i;
                     }
+                    j = border[j];
                 }
-                badCharacterTable[static_cast<int>(targetWord[i])][i] = previouslyEncounteredCharacterIndex;
+                i--;
+                j--;
+                border[i] = j;
             }
 
-            return badCharacterTable;
+            // shifts for suffixes of which only a part matches a prefix of the word
+            j = border[0];
+            for(i = 0; i <= targetLength; i++)
+            {
+                if(shift[i] == 0)
+                {
+                    shift[i] = j;
+                }
+                if(i == j)
+                {
+                    j = border[j];
+                }
+            }
+            return shift;
         }
 
         /*!
@@ -113,14 +127,14 @@ namespace Utilities
          * @param targetWord - The word to be searched
          * @return The pre-processing table for \p targetWord
          */
-        static std::vector<int> createKMPTable(const SmartString& targetWord)
+        static std::vector<int> createKMPTable(const std::string_view targetWord)
         {
             std::vector<int> table(targetWord.length(), 0);
             table[0]             = -1;
             int currentPosition  = 1;
             int currentCandidate = 0;
 
-            while(currentPosition < targetWord.length())
+            while(currentPosition < static_cast<int>(targetWord.length()))
             {
                 if(targetWord[currentPosition] == targetWord[currentCandidate])
                 {
@@ -144,36 +158,125 @@ namespace Utilities
         }
 
         /*!
-         * @brief Terminal version of SmartString::formatHelper(const int, const T&, Args...).
-         * @tparam T - Any type that is convertible to a SmartString
-         * @param depth - The format number to be replaced.
-         * @param t - The value to replace {depth} with
+         * @brief Checks whether a format argument of the form {0}, {1}, etc. starts at \p location.
+         * @param source - The format pattern
+         * @param location - Where the opening brace would be
+         * @param argument - Receives the argument number on success
+         * @param end - Receives the location just past the closing brace on success
+         * @return true if a format argument starts at \p location
          */
-        template <unsigned int depth, typename T>
-        void formatHelper(const T& t)
+        static constexpr bool parseFormatArgument(const std::string_view source, const std::string_view::size_type location,
+                                                  int& argument, std::string_view::size_type& end)
         {
-            static_assert(std::is_convertible<T, SmartString>::value, "T must be convertible to a SmartString");
-            SmartString target;
-            target << "{" << depth << "}";
-            replaceAll(target, t);
+            if(source[location] != '{')
+            {
+                return false;
+            }
+            std::string_view::size_type position = location + 1;
+            int value = 0;
+            while(position < source.length() && source[position] >= '0' && source[position] <= '9' && value < 100000)
+            {
+                value = value * 10 + (source[position] - '0');
+                position++;
+            }
+            if(position == location + 1 || position >= source.length() || source[position] != '}')
+            {
+                return false;
+            }
+            argument = value;
+            end      = position + 1;
+            return true;
         }
 
         /*!
-         * @brief Helper function to be used by SmartString::format() and its derivatives.
-         * @tparam T - Any type that is convertible to a SmartString
-         * @tparam Args - Any additional arguments
-         * @param depth - The format number to be replaced.
-         * @param t - the value to replace {depth} with
-         * @param args - additional arguments
+         * @brief Writes a number with std::to_chars directly onto the end of the backing string.
+         * @param format - The value followed by any std::to_chars formatting arguments
          */
-        template <unsigned int depth, typename T, typename... Args>
-        void formatHelper(const T& t, const Args& ...args)
+        template <typename... Format>
+        SmartString& appendNumber(const Format... format)
         {
-            static_assert(std::is_convertible<T, SmartString>::value, "T must be convertible to a SmartString");
-            SmartString target;
-            target << "{" << depth << "}";
-            replaceAll(target, t);
-            formatHelper<depth + 1>(args...);
+            const std::string::size_type oldLength = backingString.length();
+            std::string::size_type room = 32;
+            while(true)
+            {
+                backingString.resize(oldLength + room);
+                char* first = backingString.data() + oldLength;
+                const auto [end, error] = std::to_chars(first, backingString.data() + backingString.length(), format...);
+                if(error == std::errc())
+                {
+                    backingString.resize(static_cast<std::string::size_type>(end - backingString.data()));
+                    return *this;
+                }
+                // only huge magnitudes or precisions need more room than the first attempt
+                room *= 2;
+            }
+        }
+
+        // A precision of 0 still ends in the decimal point, e.g. "3.", as it always has.
+        template <typename T>
+        SmartString& appendFixed(const T val, const unsigned int valPrecision)
+        {
+            appendNumber(val, std::chars_format::fixed, static_cast<int>(valPrecision));
+            if(valPrecision == 0 && std::isfinite(val))
+            {
+                backingString.push_back('.');
+            }
+            return *this;
+        }
+
+        template <typename T>
+        SmartString& appendFloatingPoint(const T val)
+        {
+            const std::string::size_type oldLength = backingString.length();
+            appendNumber(val, std::chars_format::fixed);
+
+            const std::string::size_type decimal = backingString.find('.', oldLength);
+            if(decimal == std::string::npos)
+            {
+                if(std::isfinite(val))
+                {
+                    backingString.append(".0");
+                }
+                return *this;
+            }
+            if(length() - decimal - 1 <= static_cast<std::string::size_type>(precision))
+            {
+                return *this;
+            }
+
+            backingString.resize(oldLength);
+            appendNumber(val, std::chars_format::fixed, precision);
+            if(backingString.find('.', oldLength) != std::string::npos)
+            {
+                const std::string::size_type lastDigit = backingString.find_last_not_of('0');
+                backingString.resize(backingString[lastDigit] == '.' ? lastDigit + 2 : lastDigit + 1);
+            }
+            return *this;
+        }
+
+        template <typename T>
+        static CharacterSet toCharacterSet(const T& chars)
+        {
+            if constexpr(std::is_same<T, char>::value)
+            {
+                return CharacterSet().add(chars);
+            }
+            else if constexpr(std::is_same<T, SmartString>::value)
+            {
+                return CharacterSet(chars.backingString);
+            }
+            else if constexpr(std::is_same<T, SmartStringView>::value)
+            {
+                return CharacterSet(chars.view());
+            }
+            else if constexpr(std::is_convertible<const T&, std::string_view>::value)
+            {
+                return CharacterSet(std::string_view(chars));
+            }
+            else
+            {
+                return CharacterSet(SmartString(chars).backingString);
+            }
         }
 
         inline void checkBounds(const int lowerBound, const int upperBound) const
@@ -182,14 +285,450 @@ namespace Utilities
             if(upperBound > backingString.length()) throw std::out_of_range("Given upper bound is greater than the string size");
         }
 
+        template <typename T, typename Find>
+        [[nodiscard]] std::vector<T> split(const std::string::size_type separatorLength, Find&& find) const
+        {
+            static_assert(std::is_same<T, SmartStringView>::value || is_castable<SmartString, T>::value,
+                          "SmartString must be convertible to an object of type T");
+
+            std::vector<T> result;
+            SmartStringView::forEachToken(backingString, separatorLength, find, [this, &result](const std::string_view token) {
+                if constexpr(std::is_same<T, SmartStringView>::value)
+                {
+                    result.emplace_back(token);
+                }
+                else
+                {
+                    result.push_back(static_cast<T>(SmartString(token, getAllocator())));
+                }
+            });
+            return result;
+        }
+
     public:
+        /*!
+         * @brief A substring pattern compiled once so it can be searched for many times. Unless an
+         *        algorithm is requested, single characters use memchr, long patterns
+         *        Boyer-Moore-Horspool, and the rest are picked per search from the haystack size:
+         *        KMP below MEMCHR_SEARCH_THRESHOLD bytes, and from there a two-byte filter driven
+         *        by memchr on the first byte (16 candidate positions per step with SSE2). Full
+         *        Boyer-Moore (adding the good suffix rule) can be requested to keep shifts long on
+         *        repetitive patterns. The tables cost one 1 KB array plus about one int per pattern byte.
+         */
+        class Searcher
+        {
+        public:
+            enum class Algorithm
+            {
+                Automatic,
+                KnuthMorrisPratt,
+                BoyerMooreHorspool,
+                BoyerMoore,
+                TwoByteFilter
+            };
+
+            // Patterns longer than this are searched with Boyer-Moore-Horspool.
+            constexpr static std::string::size_type MAX_FILTER_PATTERN_LENGTH = 32;
+
+            // An automatically chosen KMP search switches to the memchr filter from this many bytes of haystack.
+            constexpr static std::string::size_type MEMCHR_SEARCH_THRESHOLD = 4096;
+
+        private:
+            std::string pattern;
+            Algorithm algorithm;
+            bool automatic;
+            std::vector<int> kmpTable;
+            std::array<int, ALPHABET_SIZE> badCharacterTable{};
+            std::vector<int> goodSuffixTable;
+
+            static Algorithm chooseAlgorithm(const std::string_view target)
+            {
+                if(target.length() > MAX_FILTER_PATTERN_LENGTH)
+                {
+                    return Algorithm::BoyerMooreHorspool;
+                }
+                // find() hands large haystacks over to the filter
+                return target.length() == 1 ? Algorithm::TwoByteFilter : Algorithm::KnuthMorrisPratt;
+            }
+
+            [[nodiscard]] std::string::size_type findKMP(const std::string_view haystack, std::string::size_type position) const
+            {
+                const auto patternLength = static_cast<int>(pattern.length());
+                int candidate = 0;
+                while(position < haystack.length())
+                {
+                    if(haystack[position] == pattern[candidate])
+                    {
+                        position++;
+                        candidate++;
+                        if(candidate == patternLength)
+                        {
+                            return position - patternLength;
+                        }
+                    }
+                    else
+                    {
+                        candidate = kmpTable[candidate];
+                        if(candidate < 0)
+                        {
+                            position++;
+                            candidate++;
+                        }
+                    }
+                }
+                return std::string::npos;
+            }
+
+            [[nodiscard]] std::string::size_type findBoyerMooreHorspool(const std::string_view haystack, std::string::size_type position) const
+            {
+                const std::string::size_type lastIndex = pattern.length() - 1;
+                while(position + lastIndex < haystack.length())
+                {
+                    const char last = haystack[position + lastIndex];
+                    if(last == pattern[lastIndex] && std::memcmp(haystack.data() + position, pattern.data(), lastIndex) == 0)
+                    {
+                        return position;
+                    }
+                    position += lastIndex - badCharacterTable[static_cast<unsigned char>(last)];
+                }
+                return std::string::npos;
+            }
+
+            [[nodiscard]] std::string::size_type findBoyerMoore(const std::string_view haystack, std::string::size_type position) const
+            {
+                const auto patternLength = static_cast<int>(pattern.length());
+                while(position + patternLength <= haystack.length())
+                {
+                    int mismatch = patternLength - 1;
+                    while(mismatch >= 0 && pattern[mismatch] == haystack[position + mismatch])
+                    {
+                        mismatch--;
+                    }
+                    if(mismatch < 0)
+                    {
+                        return position;
+                    }
+                    const int badCharacterShift = mismatch - badCharacterTable[static_cast<unsigned char>(haystack[position + mismatch])];
+                    position += std::max(goodSuffixTable[mismatch + 1], badCharacterShift);
+                }
+                return std::string::npos;
+            }
+
+            [[nodiscard]] std::string::size_type findTwoByteFilter(const std::string_view haystack, std::string::size_type position) const
+            {
+                const char* data = haystack.data();
+                const std::string::size_type patternLength = pattern.length();
+                if(patternLength == 1)
+                {
+                    const auto* found = static_cast<const char*>(std::memchr(data + position, pattern[0], haystack.length() - position));
+                    return found == nullptr ? std::string::npos : static_cast<std::string::size_type>(found - data);
+                }
+
+                const std::string::size_type lastStart = haystack.length() - patternLength;
+#if defined(__SSE2__)
+                const __m128i first  = _mm_set1_epi8(pattern[0]);
+                const __m128i second = _mm_set1_epi8(pattern[1]);
+                // each block also reads the byte after it, and every candidate must fit the pattern.
+                while(position + 16 <= lastStart + 1 && position + 17 <= haystack.length())
+                {
+                    const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position));
+                    const __m128i next    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position + 1));
+                    auto mask = static_cast<unsigned int>(_mm_movemask_epi8(
+                        _mm_and_si128(_mm_cmpeq_epi8(current, first), _mm_cmpeq_epi8(next, second))));
+                    while(mask != 0)
+                    {
+                        const std::string::size_type candidate = position + std::countr_zero(mask);
+                        if(std::memcmp(data + candidate + 2, pattern.data() + 2, patternLength - 2) == 0)
+                        {
+                            return candidate;
+                        }
+                        mask &= mask - 1;
+                    }
+                    position += 16;
+                }
+#endif
+                while(position <= lastStart)
+                {
+                    const auto* found = static_cast<const char*>(std::memchr(data + position, pattern[0], lastStart - position + 1));
+                    if(found == nullptr)
+                    {
+                        break;
+                    }
+                    position = static_cast<std::string::size_type>(found - data);
+                    if(data[position + 1] == pattern[1] && std::memcmp(data + position + 2, pattern.data() + 2, patternLength - 2) == 0)
+                    {
+                        return position;
+                    }
+                    position++;
+                }
+                return std::string::npos;
+            }
+
+        public:
+            explicit Searcher(const SmartString& target, const Algorithm requested = Algorithm::Automatic)
+                : pattern{target.backingString},
+                  algorithm{requested == Algorithm::Automatic ? chooseAlgorithm(target.backingString) : requested},
+                  automatic{requested == Algorithm::Automatic}
+            {
+                if(pattern.empty())
+                {
+                    throw std::invalid_argument("A Searcher needs a non-empty pattern");
+                }
+                if(algorithm == Algorithm::TwoByteFilter && pattern.length() > MAX_FILTER_PATTERN_LENGTH)
+                {
+                    algorithm = Algorithm::BoyerMooreHorspool;
+                }
+                if(algorithm == Algorithm::KnuthMorrisPratt)
+                {
+                    kmpTable = createKMPTable(pattern);
+                }
+                else if(algorithm == Algorithm::BoyerMooreHorspool || algorithm == Algorithm::BoyerMoore)
+                {
+                    badCharacterTable = createBoyerMooreBadCharacterTable(pattern);
+                    if(algorithm == Algorithm::BoyerMoore)
+                    {
+                        goodSuffixTable = createBoyerMooreGoodSuffixTable(pattern);
+                    }
+                }
+            }
+
+            /*!
+             * @brief Finds the first instance of the pattern in \p haystack at or after \p startingLocation.
+             * @return The location of the instance, or std::string::npos if there is none.
+             */
+            [[nodiscard]] std::string::size_type find(const std::string_view haystack, const std::string::size_type startingLocation = 0) const
+            {
+                if(startingLocation > haystack.length() || haystack.length() - startingLocation < pattern.length())
+                {
+                    return std::string::npos;
+                }
+                switch(algorithm)
+                {
+                    case Algorithm::KnuthMorrisPratt:
+                        if(automatic && haystack.length() - startingLocation >= MEMCHR_SEARCH_THRESHOLD)
+                        {
+                            return findTwoByteFilter(haystack, startingLocation);
+                        }
+                        return findKMP(haystack, startingLocation);
+                    case Algorithm::BoyerMooreHorspool: return findBoyerMooreHorspool(haystack, startingLocation);
+                    case Algorithm::BoyerMoore:         return findBoyerMoore(haystack, startingLocation);
+                    default:                            return findTwoByteFilter(haystack, startingLocation);
+                }
+            }
+
+            [[nodiscard]] inline std::string::size_type length() const
+            {
+                return pattern.length();
+            }
+
+            [[nodiscard]] inline Algorithm getAlgorithm() const
+            {
+                return algorithm;
+            }
+
+            [[nodiscard]] inline SmartStringView getPattern() const
+            {
+                return SmartStringView(pattern);
+            }
+        };
+
+        using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+        /*!
+         * @brief A monotonic buffer that SmartStrings can be allocated from, so that everything
+         *        built while processing one line or one file is handed back in one step when the
+         *        Arena goes out of scope. A string uses an Arena when given its allocator, e.g.
+         *        SmartString(text, arena.getAllocator()), and the strings derived from it (split
+         *        tokens, substrings, formatted and extracted text) use the same Arena. Copies are
+         *        made with the default resource, so a copy may safely outlive the Arena. A string
+         *        moved out of an Arena still points into it.
+         */
+        class Arena
+        {
+        private:
+            std::pmr::monotonic_buffer_resource resource;
+
+        public:
+            Arena() : resource{std::pmr::get_default_resource()} { }
+
+            // Reserves the first block of \p initialSize bytes up front.
+            explicit Arena(const size_t initialSize) : resource{initialSize, std::pmr::get_default_resource()} { }
+
+            // Allocates from \p buffer (e.g. a stack array) first, and from the heap only once it is full.
+            explicit Arena(const std::span<std::byte> buffer)
+                : resource{buffer.data(), buffer.size(), std::pmr::get_default_resource()}
+            {
+            }
+
+            Arena(const Arena& other) = delete;
+            Arena& operator=(const Arena& rhs) = delete;
+            ~Arena() = default;
+
+            // Frees everything allocated so far. Strings still using this Arena must not be touched afterwards.
+            inline void release()
+            {
+                resource.release();
+            }
+
+            [[nodiscard]] inline std::pmr::memory_resource* getResource()
+            {
+                return &resource;
+            }
+
+            [[nodiscard]] inline allocator_type getAllocator()
+            {
+                return allocator_type{&resource};
+            }
+        };
+
+        /*!
+         * @brief A format pattern whose {N} arguments have been located once, so it can be rendered
+         *        any number of times in a single pass. Created by SmartString::compileFormat().
+         */
+        class FormatTemplate
+        {
+        private:
+            struct Segment
+            {
+                std::string::size_type start;
+                std::string::size_type length;
+                int argument; // -1 for literal text
+            };
+
+            std::string pattern;
+            std::vector<Segment> segments;
+            int numArguments = 0;
+
+            template <size_t N>
+            SmartString renderValues(const std::array<SmartString, N>& values, const allocator_type& allocator) const
+            {
+                const auto isSubstituted = [](const Segment& segment) {
+                    return segment.argument >= 0 && segment.argument < static_cast<int>(N);
+                };
+
+                std::string::size_type totalLength = 0;
+                for(const auto& segment : segments)
+                {
+                    totalLength += isSubstituted(segment) ? values[segment.argument].length() : segment.length;
+                }
+
+                SmartString result(allocator);
+                result.backingString.reserve(totalLength);
+                for(const auto& segment : segments)
+                {
+                    if(isSubstituted(segment))
+                    {
+                        result.backingString.append(values[segment.argument].backingString);
+                    }
+                    else
+                    {
+                        // arguments without a value are left in place, as format() always has.
+                        result.backingString.append(pattern, segment.start, segment.length);
+                    }
+                }
+                return result;
+            }
+
+        public:
+            explicit FormatTemplate(const std::string_view source) : pattern{source}
+            {
+                std::string::size_type literalStart = 0;
+                std::string::size_type location     = pattern.find('{');
+                while(location != std::string::npos)
+                {
+                    int argument = 0;
+                    std::string::size_type end = 0;
+                    if(parseFormatArgument(pattern, location, argument, end))
+                    {
+                        if(location > literalStart)
+                        {
+                            segments.push_back({literalStart, location - literalStart, -1});
+                        }
+                        segments.push_back({location, end - location, argument});
+                        numArguments = std::max(numArguments, argument + 1);
+                        literalStart = end;
+                        location     = pattern.find('{', end);
+                    }
+                    else
+                    {
+                        location = pattern.find('{', location + 1);
+                    }
+                }
+                if(literalStart < pattern.length())
+                {
+                    segments.push_back({literalStart, pattern.length() - literalStart, -1});
+                }
+            }
+
+            /*!
+             * @brief Substitutes \p args for {0}, {1}, etc. Substituted text is never rescanned, so a
+             *        value that itself contains "{1}" comes out verbatim.
+             */
+            template <typename... Args>
+            SmartString render(const Args& ... args) const
+            {
+                static_assert((std::is_convertible<Args, SmartString>::value && ...), "Args must be convertible to a SmartString");
+                return renderUsing(allocator_type{}, args...);
+            }
+
+            // render(), with the result's memory coming from \p allocator.
+            template <typename... Args>
+            SmartString renderUsing(const allocator_type& allocator, const Args& ... args) const
+            {
+                static_assert((std::is_convertible<Args, SmartString>::value && ...), "Args must be convertible to a SmartString");
+                return renderValues(std::array<SmartString, sizeof...(Args)>{SmartString(args)...}, allocator);
+            }
+
+            // One more than the largest argument number in the pattern.
+            [[nodiscard]] inline int getNumArguments() const
+            {
+                return numArguments;
+            }
+        };
+
+        /*!
+         * @brief A string literal usable as a template argument, so that SmartString::format<"...">()
+         *        can count the pattern's arguments at compile time.
+         */
+        template <size_t N>
+        struct FormatLiteral
+        {
+            char value[N]{};
+
+            constexpr FormatLiteral(const char (&literal)[N])
+            {
+                std::copy_n(literal, N, value);
+            }
+
+            [[nodiscard]] constexpr std::string_view view() const
+            {
+                return std::string_view(value, N - 1);
+            }
+
+            [[nodiscard]] constexpr int getNumArguments() const
+            {
+                int count = 0;
+                for(std::string_view::size_type location = 0; location < N - 1; location++)
+                {
+                    int argument = 0;
+                    std::string_view::size_type end = 0;
+                    if(parseFormatArgument(view(), location, argument, end))
+                    {
+                        count = std::max(count, argument + 1);
+                    }
+                }
+                return count;
+            }
+        };
+
         SmartString() : backingString{}, precision{DEFAULT_PRECISION} { }
-        SmartString(const std::string& init) : backingString{init}, precision{DEFAULT_PRECISION} { }
-        SmartString(std::string&& init) : backingString{init}, precision{DEFAULT_PRECISION} { }
-        SmartString(const char init) : backingString{init}, precision{DEFAULT_PRECISION} { }
+        explicit SmartString(const allocator_type& allocator) : backingString{allocator}, precision{DEFAULT_PRECISION} { }
+        SmartString(const std::string& init) : backingString{std::string_view(init)}, precision{DEFAULT_PRECISION} { }
+        SmartString(std::string&& init) : backingString{std::string_view(init)}, precision{DEFAULT_PRECISION} { }
+        SmartString(const char init) : backingString(1, init), precision{DEFAULT_PRECISION} { }
         SmartString(const char* init) : backingString{init}, precision{DEFAULT_PRECISION} { }
-        SmartString(const std::stringstream& init) : backingString{init.str()}, precision{static_cast<int>(init.precision())} { }
-        SmartString(std::stringstream&& init) : backingString{init.str()}, precision{static_cast<int>(init.precision())} { }
+        SmartString(const std::stringstream& init) : backingString{std::string_view(init.str())}, precision{static_cast<int>(init.precision())} { }
+        SmartString(std::stringstream&& init) : backingString{std::string_view(init.str())}, precision{static_cast<int>(init.precision())} { }
         explicit inline SmartString(const unsigned int init) : SmartString()
         {
             append(init);
@@ -207,16 +746,29 @@ namespace Utilities
             append(init);
         }
         SmartString(const int numChars, const char fill) : backingString(numChars, fill), precision{DEFAULT_PRECISION} { }
+        SmartString(const SmartStringView& init) : backingString{init.view()}, precision{DEFAULT_PRECISION} { }
+        SmartString(const SmartStringView& init, const allocator_type& allocator) : backingString{init.view(), allocator}, precision{DEFAULT_PRECISION} { }
+        // Copies any text viewable as a std::string_view (const char*, std::string, ...) into
+        // \p allocator's memory. A template, so that it is an exact match for those arguments
+        // rather than one of several equally good conversions.
+        template <typename T>
+            requires(std::is_convertible<const T&, std::string_view>::value && !std::is_same<T, SmartString>::value)
+        SmartString(const T& init, const allocator_type& allocator) : backingString{std::string_view(init), allocator}, precision{DEFAULT_PRECISION} { }
 
+        // copies use the default resource rather than the source's, so they never point into an Arena.
         SmartString(const SmartString& other) = default;
+        SmartString(const SmartString& other, const allocator_type& allocator) : backingString{other.backingString, allocator}, precision{other.precision} { }
+        // moves keep the source's resource.
         SmartString(SmartString&& other) noexcept = default;
+        SmartString(SmartString&& other, const allocator_type& allocator) : backingString{std::move(other.backingString), allocator}, precision{other.precision} { }
         ~SmartString() = default;
         SmartString& operator=(const SmartString& rhs) = default;
-        SmartString& operator=(SmartString&& rhs) noexcept = default;
+        // copies rather than moves when the two strings use different memory resources.
+        SmartString& operator=(SmartString&& rhs) = default;
 
-        explicit inline operator std::string() const { return backingString; }
+        explicit inline operator std::string() const { return str(); }
         explicit inline operator char*() const { return c_str(); }
-        explicit operator std::stringstream() const { return std::stringstream{backingString}; }
+        explicit operator std::stringstream() const { return std::stringstream{str()}; }
 
         // iterator exposure
         auto begin()   { return std::begin(backingString);   }
@@ -271,7 +823,7 @@ namespace Utilities
 
         inline SmartString& prepend(const std::string& str)
         {
-            backingString.insert(begin(), str.begin(), str.end());
+            backingString.insert(0, str);
             return *this;
         }
 
@@ -309,14 +861,21 @@ namespace Utilities
             return *this;
         }
 
+        inline SmartString& append(const SmartStringView& str)
+        {
+            backingString.append(str.view());
+            return *this;
+        }
+
         inline SmartString& prepend(const SmartString& str)
         {
-            return prepend(str.backingString);
+            backingString.insert(0, str.backingString);
+            return *this;
         }
 
         inline SmartString& prepend(SmartString&& str)
         {
-            return prepend(str.backingString);
+            return prepend(str);
         }
 
         SmartString& append(const char c)
@@ -331,16 +890,9 @@ namespace Utilities
             return *this;
         }
 
-        SmartString& append(const unsigned int val)
+        inline SmartString& append(const unsigned int val)
         {
-            SmartString temp;
-            unsigned int num = val;
-            do {
-                unsigned int digit = num % 10;
-                temp.prepend(digitToChar(digit));
-                num /= 10;
-            } while(num > 0);
-            return append(temp);
+            return appendNumber(val);
         }
 
         inline SmartString& prepend(const unsigned int val)
@@ -348,23 +900,9 @@ namespace Utilities
             return prepend(SmartString(val));
         }
 
-        SmartString& append(const int val)
+        inline SmartString& append(const int val)
         {
-            SmartString temp;
-            bool isNegative  = val < 0;
-            unsigned int num = abs(val);
-
-            do {
-                unsigned int digit = num % 10;
-                temp.prepend(digitToChar(digit));
-                num /= 10;
-            } while(num > 0);
-
-            if(isNegative)
-            {
-                temp.prepend('-');
-            }
-            return append(temp);
+            return appendNumber(val);
         }
 
         inline SmartString& prepend(const int val)
@@ -372,97 +910,73 @@ namespace Utilities
             return prepend(SmartString(val));
         }
 
-        SmartString& append(const double val, const unsigned int valPrecision)
+        inline SmartString& append(const long val)
         {
-            SmartString temp;
-            int leftOfDecimal = static_cast<int>(val);
+            return appendNumber(val);
+        }
 
-            temp.append(leftOfDecimal);
-            temp.append('.');
+        inline SmartString& append(const unsigned long val)
+        {
+            return appendNumber(val);
+        }
 
-            double rightOfDecimal = std::abs(val) - abs(leftOfDecimal);
-            for(int i = 0; i < valPrecision; i++)
-            {
-                auto digit = static_cast<unsigned int>(rightOfDecimal * 10);
-                temp.append(digitToChar(digit));
-                rightOfDecimal = (rightOfDecimal * 10) - digit;
-            }
-            return append(temp);
+        inline SmartString& append(const long long val)
+        {
+            return appendNumber(val);
         }
 
-        SmartString& append(const double val)
+        inline SmartString& append(const unsigned long long val)
+        {
+            return appendNumber(val);
+        }
+
+        // Appends exactly valPrecision digits after the decimal point, rounded to nearest.
+        inline SmartString& append(const double val, const unsigned int valPrecision)
+        {
+            return appendFixed(val, valPrecision);
+        }
+
+        inline SmartString& append(const double val)
         {
             /*
-             * Any trailing zeroes will be removed when this method is used,
-             * unless there are only trailing zeroes, in which case one zero
-             * will be left. If you would like to include trailing zeroes,
-             * use the append method which specifies the precision.
+             * This gives the shortest representation that reads back as val,
+             * unless that needs more digits after the decimal point than the
+             * current precision, in which case it is rounded to the precision.
+             * Any trailing zeroes are removed, unless there are only trailing
+             * zeroes, in which case one zero will be left. If you would like to
+             * include trailing zeroes, use the append method which specifies
+             * the precision.
              */
-            append(val, precision);
-            if(getLast() == '0')
-            {
-                rstrip('0');
-            }
-            if(getLast() == '.')
-            {
-                append('0');
-            }
-            return *this;
+            return appendFloatingPoint(val);
         }
 
         SmartString& prepend(const double val, const unsigned int valPrecision)
         {
-            SmartString temp;
+            SmartString temp(getAllocator());
             temp.append(val, valPrecision);
             return prepend(temp);
         }
 
         SmartString& prepend(const double val)
         {
-            SmartString temp;
+            SmartString temp(getAllocator());
             temp.append(val);
             return prepend(temp);
         }
 
-        SmartString& append(const float val, const unsigned int valPrecision)
+        inline SmartString& append(const float val, const unsigned int valPrecision)
         {
-            SmartString temp;
-            auto leftOfDecimal = static_cast<unsigned int>(std::abs(val));
-
-            if(val < 0)
-            {
-                temp.append('-');
-            }
-            temp.append(leftOfDecimal);
-            temp.append('.');
-
-            float rightOfDecimal = val - static_cast<float>(leftOfDecimal);
-            for(int i = 0; i < valPrecision; i++)
-            {
-                auto digit = static_cast<unsigned int>(rightOfDecimal * 10);
-                temp.append(digitToChar(digit));
-                rightOfDecimal = (rightOfDecimal * 10) - static_cast<float>(digit);
-            }
-            return append(temp);
+            return appendFixed(val, valPrecision);
         }
 
-        SmartString& append(const float val)
+        inline SmartString& append(const float val)
         {
-            append(val, precision);
-            if(getLast() == '0')
-            {
-                rstrip('0');
-            }
-            if(getLast() == '.')
-            {
-                append('0');
-            }
-            return *this;
+            return appendFloatingPoint(val);
         }
 
         SmartString& prepend(const float val, const unsigned int valPrecision)
         {
-            SmartString temp;
+            SmartString temp(getAllocator());
             temp.append(val, valPrecision);
             return prepend(temp);
         }
@@ -490,7 +1004,7 @@ namespace Utilities
         SmartString operator+(const T& t) const
         {
             static_assert(std::is_convertible<T, SmartString>::value, "T must be convertible to a SmartString");
-            SmartString result(*this);
+            SmartString result(*this, getAllocator());
             result.append(t);
             return result;
         }
@@ -502,17 +1016,17 @@ namespace Utilities
 
         inline bool operator!=(const std::stringstream& strm) const
         {
-            return backingString != strm.str();
+            return std::string_view(backingString) != strm.str();
         }
 
         inline bool operator!=(const std::string& str) const
         {
-            return backingString != str;
+            return std::string_view(backingString) != str;
         }
 
         inline bool operator!=(const char* str) const
         {
-            return backingString != std::string(str);
+            return std::string_view(backingString) != str;
         }
 
         bool operator==(const SmartString& str) const
@@ -522,17 +1036,17 @@ namespace Utilities
 
         inline bool operator==(const std::stringstream& strm) const
         {
-            return backingString == strm.str();
+            return std::string_view(backingString) == strm.str();
         }
 
         bool operator==(const std::string& str) const
         {
-            return backingString == str;
+            return std::string_view(backingString) == str;
         }
 
         bool operator==(const char* str) const
         {
-            return backingString == std::string(str);
+            return std::string_view(backingString) == str;
         }
 
         bool operator<(const SmartString& str) const
@@ -713,7 +1227,7 @@ namespace Utilities
 
         [[nodiscard]] SmartString getSubstring(const std::string::size_type startLocation, const std::string::size_type endLocation) const
         {
-            return backingString.substr(startLocation, endLocation - startLocation + 1);
+            return SmartString(view().getSubstring(startLocation, endLocation), getAllocator());
         }
 
         template <typename T>
@@ -740,6 +1254,21 @@ namespace Utilities
             return findSubstring(0, SmartString(target));
         }
 
+        [[nodiscard]] inline std::string::size_type findSubstring(const std::string::size_type startingLocation, const Searcher& searcher) const
+        {
+            return searcher.find(backingString, startingLocation);
+        }
+
+        [[nodiscard]] inline std::string::size_type findSubstring(const Searcher& searcher) const
+        {
+            return findSubstring(0, searcher);
+        }
+
+        [[nodiscard]] inline bool contains(const Searcher& searcher) const
+        {
+            return findSubstring(searcher) != std::string::npos;
+        }
+
         template <typename T>
         [[nodiscard]] inline bool contains(const T& target) const
         {
@@ -747,6 +1276,21 @@ namespace Utilities
             return findSubstring(target) != std::string::npos;
         }
 
+        /*!
+         * @brief Counts the instances of a precompiled pattern, including overlapping ones.
+         */
+        unsigned int count(const Searcher& searcher) const
+        {
+            unsigned int numInstances = 0;
+            std::string::size_type location = findSubstring(searcher);
+            while(location != std::string::npos)
+            {
+                numInstances++;
+                location = findSubstring(location + 1, searcher);
+            }
+            return numInstances;
+        }
+
         template <typename T>
         unsigned int count(const T& target) const
         {
@@ -762,43 +1306,78 @@ namespace Utilities
             return numInstances;
         }
 
+        /*!
+         * @brief Finds every occurrence of any of the matcher's patterns, overlapping ones included,
+         *        in a single pass.
+         */
+        [[nodiscard]] inline std::vector<MultiPatternMatcher::Match> findAll(const MultiPatternMatcher& patterns) const
+        {
+            return patterns.findAll(backingString);
+        }
+
+        [[nodiscard]] inline std::vector<MultiPatternMatcher::Match> findAll(const std::initializer_list<std::string_view> patterns) const
+        {
+            return findAll(MultiPatternMatcher(patterns));
+        }
+
+        /*!
+         * @brief The first match of any of the matcher's patterns in its scan direction, see
+         *        MultiPatternMatcher::findFirst().
+         */
+        [[nodiscard]] inline std::optional<MultiPatternMatcher::Match> findFirst(const MultiPatternMatcher& patterns) const
+        {
+            return patterns.findFirst(backingString);
+        }
+
         template<typename T>
         std::vector<T> split() const
         {
             return split<T>(" ");
         }
 
+        /*!
+         * @brief Splits this string on \p target in a single pass. Splitting into SmartStringView
+         *        yields views into this string's buffer instead of copies, so the result must not
+         *        outlive this string (or any modification of it).
+         * @tparam T - The token type. SmartStringView, or anything SmartString is castable to.
+         * @param target - The separator to split on
+         * @return The tokens, in order. A trailing separator does not produce an empty token.
+         */
         template <typename T, typename U>
         [[nodiscard]] std::vector<T> split(const U& target) const
         {
-            static_assert(is_castable<SmartString, T>::value, "SmartString must be convertible to an object of type T");
             static_assert(std::is_convertible<U, SmartString>::value, "U must be convertible to a SmartString");
 
-            std::vector<T> result;
-            SmartString temp(*this);
-            SmartString targ(target);
-            std::string::size_type location = temp.findSubstring(targ);
-            while(location != std::string::npos)
-            {
-                if(location == 0)
-                {
-                    result.push_back("");
-                    temp.remove(0, 0);
-                }
-                else
-                {
-                    result.push_back(temp.getSubstring<T>(0, location - 1));
-                    temp.remove(0, location + targ.length() - 1);
-                }
-                location = temp.findSubstring(targ);
-            }
-            if(temp.length() > 0)
+            const SmartString targ(target);
+            if(targ.isEmpty())
             {
-                result.push_back(static_cast<T>(temp));
+                return split<T>(targ.backingString.length(), [](std::string::size_type) { return std::string::npos; });
             }
-            return result;
+            return split<T>(targ.length(), [this, &targ](const std::string::size_type position) {
+                return backingString.find(targ.backingString, position);
+            });
+        }
+
+        template <typename T>
+        [[nodiscard]] inline std::vector<T> split(const Searcher& searcher) const
+        {
+            return split<T>(searcher.length(), [this, &searcher](const std::string::size_type position) {
+                return findSubstring(position, searcher);
+            });
+        }
+
+        /*!
+         * @brief Lazily splits this string on \p separator, see SmartStringView::tokens(). The tokens
+         *        are views into this string, so they are invalidated by any modification of it, and
+         *        cannot be taken from a temporary.
+         */
+        [[nodiscard]] inline SmartStringView::TokenRange tokens(const SmartStringView& separator = " ") const&
+        {
+            return view().tokens(separator);
         }
 
+        SmartStringView::TokenRange tokens(const SmartStringView& separator = " ") const&& = delete;
+
         template <typename T, typename U, typename V>
         static T join(const std::vector<U>& list, const V& separator)
         {
@@ -835,58 +1414,58 @@ namespace Utilities
 
         inline SmartString& lstrip()
         {
-            lstrip(whitespace());
-            return *this;
+            return lstrip(CharacterSet::whitespace());
         }
 
         inline SmartString& rstrip()
         {
-            rstrip(whitespace());
-            return *this;
+            return rstrip(CharacterSet::whitespace());
         }
 
         inline SmartString& strip()
         {
-            lstrip(whitespace());
-            rstrip(whitespace());
+            return strip(CharacterSet::whitespace());
+        }
+
+        SmartString& lstrip(const CharacterSet& chars)
+        {
+            backingString.erase(0, chars.countLeading(backingString));
+            return *this;
+        }
+
+        SmartString& rstrip(const CharacterSet& chars)
+        {
+            backingString.resize(length() - chars.countTrailing(backingString));
+            return *this;
+        }
+
+        inline SmartString& strip(const CharacterSet& chars)
+        {
+            // trimming the end first means the front erase moves fewer characters
+            rstrip(chars);
+            lstrip(chars);
             return *this;
         }
 
         template <typename T>
-        SmartString& lstrip(const T& chars)
+        inline SmartString& lstrip(const T& chars)
         {
             static_assert(std::is_convertible<T, SmartString>::value, "T must be convertible to a SmartString");
-            const SmartString toStrip(chars);
-            int index           = 0;
-            while(index < length() && toStrip.contains(backingString[index]))
-            {
-                index++;
-            }
-            remove(0, index - 1);
-            return *this;
+            return lstrip(toCharacterSet(chars));
         }
 
         template <typename T>
-        SmartString& rstrip(const T& chars)
+        inline SmartString& rstrip(const T& chars)
         {
             static_assert(std::is_convertible<T, SmartString>::value, "T must be convertible to a SmartString");
-            const SmartString toStrip(chars);
-            int index           = static_cast<int>(length()) - 1;
-            while(index >= 0 && toStrip.contains(backingString[index]))
-            {
-                index--;
-            }
-            remove(index + 1, static_cast<int>(length()) - 1);
-            return *this;
+            return rstrip(toCharacterSet(chars));
         }
 
         template <typename T>
         inline SmartString& strip(const T& chars)
         {
             static_assert(std::is_convertible<T, SmartString>::value, "T must be convertible to a SmartString");
-            lstrip(chars);
-            rstrip(chars);
-            return *this;
+            return strip(toCharacterSet(chars));
         }
 
         // start and end are both inclusive.
@@ -913,15 +1492,14 @@ namespace Utilities
             return remove(SmartString(target));
         }
 
-        SmartString& removeAll(const SmartString& target)
+        /*!
+         * @brief Removes every non-overlapping instance of \p target in one left-to-right pass. Text
+         *        that only becomes a match once its neighbours are removed is kept, so removing "ab"
+         *        from "aabb" leaves "ab".
+         */
+        inline SmartString& removeAll(const SmartString& target)
         {
-            bool changed;
-            do {
-                SmartString old(*this);
-                remove(target);
-                changed = (old != *this);
-            } while(changed);
-            return *this;
+            return replaceAll(target, SmartString());
         }
 
         template <typename T>
@@ -953,18 +1531,91 @@ namespace Utilities
             return replace(SmartString(target), SmartString(newSubstring));
         }
 
-        SmartString& replaceAll(const SmartString& target, const SmartString& newSubstring)
+        /*!
+         * @brief Replaces every non-overlapping instance of the precompiled pattern, scanning left
+         *        to right once. Text that comes from \p newSubstring is never rescanned, so
+         *        replacing "a" with "aa" terminates.
+         * @param searcher - The pattern to be replaced
+         * @param newSubstring - The replacement text
+         * @return *this
+         */
+        SmartString& replaceAll(const Searcher& searcher, const SmartString& newSubstring)
         {
-            bool changed;
-            do {
-                SmartString old = *this;
-                replace(target, newSubstring);
-                changed = (old != *this);
-            } while(changed);
+            if(&newSubstring == this)
+            {
+                return replaceAll(searcher, SmartString(newSubstring));
+            }
+            const std::string::size_type patternLength = searcher.length();
+            const std::string_view replacement(newSubstring.backingString);
 
+            // The text can only shrink, so it is rewritten in place as the scan goes: everything
+            // written lies before the point the next search starts from.
+            if(replacement.length() <= patternLength)
+            {
+                char* const data = backingString.data();
+                std::string::size_type written    = 0;
+                std::string::size_type copiedUpTo = 0;
+                for(auto location = findSubstring(searcher); location != std::string::npos;
+                    location = findSubstring(location + patternLength, searcher))
+                {
+                    if(written != copiedUpTo)
+                    {
+                        std::memmove(data + written, data + copiedUpTo, location - copiedUpTo);
+                    }
+                    written += location - copiedUpTo;
+                    std::memcpy(data + written, replacement.data(), replacement.length());
+                    written += replacement.length();
+                    copiedUpTo = location + patternLength;
+                }
+                if(written != copiedUpTo)
+                {
+                    std::memmove(data + written, data + copiedUpTo, length() - copiedUpTo);
+                    backingString.resize(written + length() - copiedUpTo);
+                }
+                return *this;
+            }
+
+            // The text grows, so the matches are counted first to size the result exactly, and
+            // the second scan writes straight into it.
+            std::string::size_type numMatches = 0;
+            for(auto location = findSubstring(searcher); location != std::string::npos;
+                location = findSubstring(location + patternLength, searcher))
+            {
+                numMatches++;
+            }
+            if(numMatches == 0)
+            {
+                return *this;
+            }
+
+            std::pmr::string result(backingString.get_allocator());
+            result.reserve(length() + numMatches * (replacement.length() - patternLength));
+            std::string::size_type copiedUpTo = 0;
+            for(auto location = findSubstring(searcher); location != std::string::npos;
+                location = findSubstring(location + patternLength, searcher))
+            {
+                result.append(backingString, copiedUpTo, location - copiedUpTo);
+                result.append(replacement);
+                copiedUpTo = location + patternLength;
+            }
+            result.append(backingString, copiedUpTo, std::string::npos);
+            backingString = std::move(result);
             return *this;
         }
 
+        inline SmartString& replaceAll(const SmartString& target, const SmartString& newSubstring)
+        {
+            if(isEmpty() || target.isEmpty()) return *this;
+            return replaceAll(Searcher(target), newSubstring);
+        }
+
+        template <typename U>
+        inline SmartString& replaceAll(const Searcher& searcher, const U& newSubstring)
+        {
+            static_assert(std::is_convertible<U, SmartString>::value, "U must be convertible to a SmartString");
+            return replaceAll(searcher, SmartString(newSubstring));
+        }
+
         template <typename T, typename U>
         inline SmartString& replaceAll(const T& target, const U& newSubstring)
         {
@@ -973,10 +1624,28 @@ namespace Utilities
             return replaceAll(SmartString(target), SmartString(newSubstring));
         }
 
+        /*!
+         * @brief Parses the {N} format arguments of \p pattern once, for repeated rendering.
+         */
+        template <typename T>
+        static FormatTemplate compileFormat(const T& pattern)
+        {
+            static_assert(std::is_convertible<T, SmartString>::value, "T must be convertible to a SmartString");
+            if constexpr(std::is_convertible<const T&, std::string_view>::value)
+            {
+                return FormatTemplate(std::string_view(pattern));
+            }
+            else
+            {
+                return FormatTemplate(SmartString(pattern).backingString);
+            }
+        }
+
         template <typename... Args>
         inline SmartString& format(const Args& ... args)
         {
-            formatHelper<0>(args...);
+            // only the characters change, the precision is kept
+            backingString = FormatTemplate(backingString).renderUsing(getAllocator(), args...).backingString;
             return *this;
         }
 
@@ -984,9 +1653,7 @@ namespace Utilities
         inline T getFormatted(const Args& ... args) const
         {
             static_assert(is_castable<SmartString, T>::value, "SmartString must be convertible to an object of type T");
-            SmartString result(*this);
-            result.formatHelper<0>(args...);
-            return static_cast<T>(result);
+            return static_cast<T>(FormatTemplate(backingString).renderUsing(getAllocator(), args...));
         }
 
         template <typename T, typename U, typename... Args>
@@ -994,104 +1661,103 @@ namespace Utilities
         {
             static_assert(is_castable<SmartString, T>::value, "SmartString must be convertible to an object of type T");
             static_assert(std::is_convertible<U, SmartString>::value, "U must be convertible to a SmartString");
-            SmartString result(source);
-            result.formatHelper<0>(args...);
-            return static_cast<T>(result);
+            return static_cast<T>(compileFormat(source).render(args...));
+        }
+
+        /*!
+         * @brief Formats a literal pattern, checking at compile time that one value is given for each
+         *        of its arguments. The pattern is parsed only once per program.
+         */
+        template <FormatLiteral pattern, typename... Args>
+        static SmartString format(const Args& ... args)
+        {
+            static_assert(pattern.getNumArguments() == sizeof...(Args), "The number of values must match the number of format arguments");
+            static const FormatTemplate compiled(pattern.view());
+            return compiled.render(args...);
         }
 
         // Assumes a-z and A-Z are contiguous. will break if they aren't.
-        SmartString& toUpper()
+        inline SmartString& toUpper()
         {
-            constexpr auto a = static_cast<int>('a');
-            constexpr auto A = static_cast<int>('A');
-            constexpr auto z = static_cast<int>('z');
-            for(unsigned int i = 0; i < length(); i++)
-            {
-                const auto letterVal = static_cast<int>(static_cast<unsigned char>(backingString[i]));
-                if(letterVal >= a && letterVal <= z)
-                {
-                    backingString[i] = static_cast<char>(letterVal - a + A);
-                }
-            }
+            AsciiKernels::toUpper(backingString.data(), length());
             return *this;
         }
 
         // Assumes a-z and A-Z are contiguous. will break if they aren't.
-        SmartString& toLower()
+        inline SmartString& toLower()
         {
-            constexpr auto a = static_cast<int>('a');
-            constexpr auto A = static_cast<int>('A');
-            constexpr auto Z = static_cast<int>('Z');
-            for(int i = 0; i < length(); i++)
-            {
-                const auto letterVal = static_cast<int>(static_cast<unsigned char>(backingString[i]));
-                if(letterVal >= A && letterVal <= Z)
-                {
-                    backingString[i] = static_cast<char>(letterVal - A + a);
-                }
-            }
+            AsciiKernels::toLower(backingString.data(), length());
+            return *this;
+        }
+
+        /*!
+         * @brief Marks which characters of this string belong to any of \p classes.
+         * @return A bitmap where bit (i % 64) of word (i / 64) is set when character i is in \p classes.
+         */
+        [[nodiscard]] inline std::vector<uint64_t> getClassMask(const AsciiClass classes) const
+        {
+            return AsciiKernels::classMask(backingString.data(), length(), classes);
+        }
+
+        /*!
+         * @brief Provides only the characters of this string that belong to any of \p classes, in order.
+         */
+        [[nodiscard]] SmartString extract(const AsciiClass classes) const
+        {
+            SmartString result(getAllocator());
+            result.backingString.resize(length());
+            result.backingString.resize(AsciiKernels::extract(backingString.data(), length(), classes, result.backingString.data()));
+            return result;
+        }
+
+        [[nodiscard]] inline SmartString extractDigits() const
+        {
+            return extract(AsciiClass::Digit);
+        }
+
+        /*!
+         * @brief Replaces every character c of this string with table[c].
+         *        See AsciiKernels::createTranslationTable() for building a table.
+         */
+        inline SmartString& translate(const AsciiKernels::TranslationTable& table)
+        {
+            AsciiKernels::translate(backingString.data(), length(), table);
             return *this;
         }
 
+        // Replaces each character of from with the character at the same position in to.
+        inline SmartString& translate(const std::string_view from, const std::string_view to)
+        {
+            return translate(AsciiKernels::createTranslationTable(from, to));
+        }
+
+        /*!
+         * @brief Parses \p source into \p out without copying it when \p source is already
+         *        backed by contiguous characters. See SmartStringView::tryConvert for the format.
+         * @return true on success, false if \p source was not a valid number for U.
+         */
         template <typename T, typename U>
         static bool tryConvert(const T& source, U& out)
         {
             static_assert(std::is_convertible<T, SmartString>::value, "T must be convertible to a SmartString");
             static_assert(std::is_arithmetic<U>::value, "U must be an arithmetic type");
 
-            SmartString src(source);
-            if(src.isEmpty())
+            if constexpr(std::is_same<T, SmartString>::value)
             {
-                return false;
+                return SmartStringView::tryConvert(source.backingString, out);
             }
-            int sign = 1;
-            if(src[0] == '-')
+            else if constexpr(std::is_same<T, SmartStringView>::value)
             {
-                sign = -1;
-                src.lstrip("-");
+                return SmartStringView::tryConvert(source.view(), out);
             }
-
-            SmartString leftOfDecimal;
-            SmartString rightOfDecimal;
-            std::vector<SmartString> results = src.split<SmartString>(".");
-            double answer = 0;
-
-            if(results.size() > 2 || results.empty())
-            {
-                return false;
-            }
-            else if(results.size() == 2)
-            {
-                rightOfDecimal = results[1];
-            }
-            leftOfDecimal = results[0];
-
-            int multiplier = 1;
-            for(int i = static_cast<int>(leftOfDecimal.length()) - 1; i >= 0; i--)
+            else if constexpr(std::is_convertible<const T&, std::string_view>::value)
             {
-                unsigned int num = charToDigit(leftOfDecimal[i]);
-                if(num > 9)
-                {
-                    return false;
-                }
-                answer += (num * multiplier);
-                multiplier *= 10;
+                return SmartStringView::tryConvert(std::string_view(source), out);
             }
-
-            double divisor = 10;
-            for(unsigned int i = 0; i < rightOfDecimal.length(); i++)
+            else
             {
-                unsigned int num = charToDigit(rightOfDecimal[i]);
-                if(num > 9)
-                {
-                    return false;
-                }
-                answer += (num / divisor);
-                divisor *= 10;
+                return SmartStringView::tryConvert(SmartString(source).backingString, out);
             }
-
-            out = static_cast<U>(answer * sign);
-            return true;
         }
 
         template <typename T, typename U>
@@ -1130,7 +1796,7 @@ namespace Utilities
                 return temp;
             }
             SmartString errorStream;
-            errorStream << "This string could not be parsed into a valid number: " << backingString;
+            errorStream << "This string could not be parsed into a valid number: " << view();
             throw std::invalid_argument(errorStream.str());
         };
 
@@ -1146,9 +1812,18 @@ namespace Utilities
             return static_cast<T>(whitespace());
         }
 
+        /*!
+         * @brief Provides a non-owning view of this string. The view is invalidated by any
+         *        modification of this string.
+         */
+        [[nodiscard]] inline SmartStringView view() const
+        {
+            return SmartStringView(backingString);
+        }
+
         [[nodiscard]] inline std::string str() const
         {
-            return std::string{backingString};
+            return std::string(backingString.data(), backingString.length());
         }
 
         [[nodiscard]] inline char* c_str() const
@@ -1166,6 +1841,11 @@ namespace Utilities
             return result;
         }
 
+        [[nodiscard]] inline allocator_type getAllocator() const
+        {
+            return backingString.get_allocator();
+        }
+
         [[nodiscard]] inline size_t length() const
         {
             return backingString.length();
@@ -0,0 +1,515 @@
+//
+// Non-owning companion to SmartString.
+//
+
+#ifndef UTILITYCODE_SMARTSTRINGVIEW_H
+#define UTILITYCODE_SMARTSTRINGVIEW_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <iterator>
+#include <ostream>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include <type_traits>
+#include <utility>
+
+#include "CharacterSet.h"
+
+
+namespace Utilities
+{
+    /*!
+     * @brief A read-only window into a string owned by someone else (usually a SmartString
+     *        or a std::string). Splitting and stripping a SmartStringView only moves the
+     *        window's bounds, so no characters are ever copied. The owner must outlive
+     *        every view taken from it.
+     */
+    class SmartStringView
+    {
+    private:
+        template<typename From, typename To, typename = void>
+        struct is_castable : std::false_type { };
+
+        template<typename From, typename To>
+        struct is_castable<From, To, typename std::enable_if<std::is_convertible<
+        decltype(static_cast<To>(std::declval<From>())), To>::value>::type>
+        : std::true_type { };
+
+        std::string_view backingView;
+
+        static constexpr bool isDigits(const std::string_view digits)
+        {
+            return std::all_of(digits.begin(), digits.end(), [](const char c) { return c >= '0' && c <= '9'; });
+        }
+
+    public:
+        class TokenRange;
+
+        constexpr SmartStringView() : backingView{} { }
+        constexpr SmartStringView(std::string_view init) : backingView{init} { }
+        constexpr SmartStringView(const char* init) : backingView{init} { }
+        constexpr SmartStringView(const char* init, const std::string_view::size_type size) : backingView{init, size} { }
+        SmartStringView(const std::string& init) : backingView{init} { }
+
+        // a view into a temporary would dangle as soon as the statement ends.
+        SmartStringView(std::string&& init) = delete;
+
+        constexpr SmartStringView(const SmartStringView& other) = default;
+        constexpr SmartStringView& operator=(const SmartStringView& rhs) = default;
+        ~SmartStringView() = default;
+
+        explicit operator std::string() const { return std::string{backingView}; }
+
+        // iterator exposure
+        [[nodiscard]] constexpr auto begin()   const { return std::begin(backingView);   }
+        [[nodiscard]] constexpr auto end()     const { return std::end(backingView);     }
+        [[nodiscard]] constexpr auto rbegin()  const { return std::rbegin(backingView);  }
+        [[nodiscard]] constexpr auto rend()    const { return std::rend(backingView);    }
+        [[nodiscard]] constexpr auto cbegin()  const { return std::cbegin(backingView);  }
+        [[nodiscard]] constexpr auto cend()    const { return std::cend(backingView);    }
+        [[nodiscard]] constexpr auto crbegin() const { return std::crbegin(backingView); }
+        [[nodiscard]] constexpr auto crend()   const { return std::crend(backingView);   }
+
+        constexpr char operator[](const size_t index) const
+        {
+            return backingView[index];
+        }
+
+        constexpr bool operator==(const SmartStringView& rhs) const
+        {
+            return backingView == rhs.backingView;
+        }
+
+        constexpr bool operator!=(const SmartStringView& rhs) const
+        {
+            return backingView != rhs.backingView;
+        }
+
+        constexpr bool operator<(const SmartStringView& rhs) const
+        {
+            return backingView < rhs.backingView;
+        }
+
+        friend std::ostream& operator<<(std::ostream& out, const SmartStringView& view)
+        {
+            out << view.backingView;
+            return out;
+        }
+
+        [[nodiscard]] constexpr std::string_view view() const
+        {
+            return backingView;
+        }
+
+        [[nodiscard]] std::string str() const
+        {
+            return std::string{backingView};
+        }
+
+        [[nodiscard]] constexpr const char* data() const
+        {
+            return backingView.data();
+        }
+
+        [[nodiscard]] constexpr size_t length() const
+        {
+            return backingView.length();
+        }
+
+        [[nodiscard]] constexpr bool isEmpty() const
+        {
+            return backingView.empty();
+        }
+
+        [[nodiscard]] constexpr char getFirst() const
+        {
+            return backingView.front();
+        }
+
+        [[nodiscard]] constexpr char getLast() const
+        {
+            return backingView.back();
+        }
+
+        // start and end are both inclusive, to match SmartString::getSubstring.
+        [[nodiscard]] constexpr SmartStringView getSubstring(const std::string_view::size_type startLocation, const std::string_view::size_type endLocation) const
+        {
+            return backingView.substr(startLocation, endLocation - startLocation + 1);
+        }
+
+        [[nodiscard]] constexpr std::string_view::size_type findSubstring(const std::string_view::size_type startingLocation, const SmartStringView& target) const
+        {
+            return backingView.find(target.backingView, startingLocation);
+        }
+
+        [[nodiscard]] constexpr std::string_view::size_type findSubstring(const SmartStringView& target) const
+        {
+            return findSubstring(0, target);
+        }
+
+        [[nodiscard]] constexpr bool contains(const SmartStringView& target) const
+        {
+            return findSubstring(target) != std::string_view::npos;
+        }
+
+        [[nodiscard]] constexpr bool contains(const char c) const
+        {
+            return backingView.find(c) != std::string_view::npos;
+        }
+
+        /*!
+         * @brief Calls \p emit once for every token of \p source. This is the tokenizing rule shared by
+         *        SmartString::split and SmartStringView::split: a separator at the very start produces
+         *        an empty token, but a trailing separator does not.
+         * @param source - The characters to be split
+         * @param separatorLength - The length of the delimiter
+         * @param find - Callable returning the location of the next delimiter at or after a position,
+         *               or std::string_view::npos if there are no more.
+         * @param emit - Callable taking a std::string_view.
+         */
+        template <typename Find, typename Emit>
+        static constexpr void forEachToken(const std::string_view source, const std::string_view::size_type separatorLength, Find&& find, Emit&& emit)
+        {
+            std::string_view::size_type position = 0;
+            while(true)
+            {
+                const std::string_view::size_type location = find(position);
+                if(location == std::string_view::npos)
+                {
+                    if(position < source.length())
+                    {
+                        emit(source.substr(position));
+                    }
+                    return;
+                }
+                emit(source.substr(position, location - position));
+                position = location + separatorLength;
+            }
+        }
+
+        template <typename Emit>
+        static constexpr void forEachToken(const std::string_view source, const std::string_view separator, Emit&& emit)
+        {
+            if(separator.empty())
+            {
+                // an empty delimiter yields the whole source as a single token.
+                forEachToken(source, 0, [](std::string_view::size_type) { return std::string_view::npos; }, emit);
+                return;
+            }
+            forEachToken(source, separator.length(), [source, separator](const std::string_view::size_type position) {
+                return source.find(separator, position);
+            }, emit);
+        }
+
+        template <typename T = SmartStringView>
+        [[nodiscard]] std::vector<T> split() const
+        {
+            return split<T>(" ");
+        }
+
+        /*!
+         * @brief Splits this view on \p target in a single pass. When T is SmartStringView the tokens
+         *        point into the same buffer as this view and nothing is allocated besides the vector.
+         */
+        template <typename T = SmartStringView>
+        [[nodiscard]] std::vector<T> split(const SmartStringView& target) const
+        {
+            static_assert(is_castable<SmartStringView, T>::value, "SmartStringView must be convertible to an object of type T");
+
+            std::vector<T> result;
+            forEachToken(backingView, target.backingView, [&result](const std::string_view token) {
+                result.push_back(static_cast<T>(SmartStringView(token)));
+            });
+            return result;
+        }
+
+        /*!
+         * @brief Lazily splits this view on \p separator. Delimiters are searched for only as the
+         *        range is iterated, so composing with std::views::take, drop or filter touches only
+         *        the bytes the pipeline actually consumes. Tokens follow the same rules as split().
+         * @param separator - The delimiter. Must outlive the returned range.
+         */
+        [[nodiscard]] constexpr TokenRange tokens(const SmartStringView& separator = " ") const;
+
+        inline SmartStringView& lstrip()
+        {
+            return lstrip(CharacterSet::whitespace());
+        }
+
+        inline SmartStringView& rstrip()
+        {
+            return rstrip(CharacterSet::whitespace());
+        }
+
+        inline SmartStringView& strip()
+        {
+            return strip(CharacterSet::whitespace());
+        }
+
+        SmartStringView& lstrip(const CharacterSet& chars)
+        {
+            backingView.remove_prefix(chars.countLeading(backingView));
+            return *this;
+        }
+
+        SmartStringView& rstrip(const CharacterSet& chars)
+        {
+            backingView.remove_suffix(chars.countTrailing(backingView));
+            return *this;
+        }
+
+        inline SmartStringView& strip(const CharacterSet& chars)
+        {
+            lstrip(chars);
+            rstrip(chars);
+            return *this;
+        }
+
+        inline SmartStringView& lstrip(const SmartStringView& chars)
+        {
+            return lstrip(CharacterSet(chars.backingView));
+        }
+
+        inline SmartStringView& rstrip(const SmartStringView& chars)
+        {
+            return rstrip(CharacterSet(chars.backingView));
+        }
+
+        inline SmartStringView& strip(const SmartStringView& chars)
+        {
+            return strip(CharacterSet(chars.backingView));
+        }
+
+        inline SmartStringView& lstrip(const char c)
+        {
+            return lstrip(CharacterSet().add(c));
+        }
+
+        inline SmartStringView& rstrip(const char c)
+        {
+            return rstrip(CharacterSet().add(c));
+        }
+
+        inline SmartStringView& strip(const char c)
+        {
+            return strip(CharacterSet().add(c));
+        }
+
+        /*!
+         * @brief Parses \p source as a (possibly negative) decimal number in place, without
+         *        allocating. Integral results are parsed exactly (any fractional part is
+         *        truncated, as a cast would), so 64-bit values do not lose precision.
+         * @param source - Characters of the form [-]digits[.digits]
+         * @param out - Receives the parsed value on success, untouched otherwise
+         * @return true if \p source was a valid number that fits in U, false otherwise.
+         */
+        template <typename U>
+        static bool tryConvert(std::string_view source, U& out)
+        {
+            static_assert(std::is_arithmetic<U>::value, "U must be an arithmetic type");
+
+            const std::string_view number = source;
+            const bool isNegative = !source.empty() && source.front() == '-';
+            if(isNegative)
+            {
+                source.remove_prefix(1);
+            }
+            if(source.empty())
+            {
+                return false;
+            }
+
+            std::string_view leftOfDecimal = source;
+            std::string_view rightOfDecimal;
+            const auto decimal = source.find('.');
+            if(decimal != std::string_view::npos)
+            {
+                leftOfDecimal  = source.substr(0, decimal);
+                rightOfDecimal = source.substr(decimal + 1);
+            }
+            if(!isDigits(leftOfDecimal) || !isDigits(rightOfDecimal))
+            {
+                return false;
+            }
+
+            if constexpr(std::is_floating_point<U>::value)
+            {
+                U result{};
+                if(leftOfDecimal.empty() && rightOfDecimal.empty())
+                {
+                    // a lone "." is zero; from_chars would want at least one digit.
+                    out = isNegative ? -result : result;
+                    return true;
+                }
+                const auto [end, error] = std::from_chars(number.data(), number.data() + number.length(), result, std::chars_format::fixed);
+                if(error != std::errc() || end != number.data() + number.length())
+                {
+                    return false;
+                }
+                out = result;
+                return true;
+            }
+            else if constexpr(std::is_same<U, bool>::value)
+            {
+                const auto isNonZero = [](const std::string_view digits) {
+                    return digits.find_first_not_of('0') != std::string_view::npos;
+                };
+                out = isNonZero(leftOfDecimal) || isNonZero(rightOfDecimal);
+                return true;
+            }
+            else
+            {
+                U result{};
+                if(!leftOfDecimal.empty())
+                {
+                    // signed types parse the '-' themselves, so "-9223372036854775808" still fits.
+                    const char* first = (isNegative && std::is_signed<U>::value) ? number.data() : leftOfDecimal.data();
+                    const char* last  = leftOfDecimal.data() + leftOfDecimal.length();
+                    const auto [end, error] = std::from_chars(first, last, result);
+                    if(error != std::errc() || end != last)
+                    {
+                        return false;
+                    }
+                }
+                if(isNegative && !std::is_signed<U>::value && result != 0)
+                {
+                    return false;
+                }
+                out = result;
+                return true;
+            }
+        }
+
+        template <typename T>
+        inline bool tryConvert(T& out) const
+        {
+            static_assert(std::is_arithmetic<T>::value, "T must be an arithmetic type");
+            return tryConvert(backingView, out);
+        }
+
+        template <typename T>
+        T convert() const
+        {
+            static_assert(std::is_arithmetic<T>::value, "T must be an arithmetic type");
+            T temp;
+            if(tryConvert(temp))
+            {
+                return temp;
+            }
+            throw std::invalid_argument("This string could not be parsed into a valid number: " + str());
+        }
+    };
+
+    /*!
+     * @brief A forward range over the tokens of a string, see SmartStringView::tokens().
+     *        It does not own the characters it walks, so its iterators stay valid for as long as
+     *        the underlying string does, even after the range object itself is gone.
+     */
+    class SmartStringView::TokenRange : public std::ranges::view_interface<SmartStringView::TokenRange>
+    {
+    private:
+        std::string_view source;
+        std::string_view separator;
+
+    public:
+        class Iterator
+        {
+        private:
+            std::string_view source;
+            std::string_view separator;
+            std::string_view::size_type position = 0;
+            std::string_view::size_type tokenEnd = 0;
+            bool atEnd                           = true;
+
+            constexpr void findTokenEnd()
+            {
+                tokenEnd = separator.empty() ? std::string_view::npos : source.find(separator, position);
+                if(tokenEnd == std::string_view::npos)
+                {
+                    tokenEnd = source.length();
+                }
+            }
+
+        public:
+            using iterator_concept  = std::forward_iterator_tag;
+            using iterator_category = std::input_iterator_tag;
+            using value_type        = SmartStringView;
+            using difference_type   = std::ptrdiff_t;
+
+            constexpr Iterator() = default;
+            constexpr Iterator(const std::string_view source, const std::string_view separator)
+                : source{source}, separator{separator}, atEnd{source.empty()}
+            {
+                if(!atEnd)
+                {
+                    findTokenEnd();
+                }
+            }
+
+            constexpr SmartStringView operator*() const
+            {
+                return source.substr(position, tokenEnd - position);
+            }
+
+            constexpr Iterator& operator++()
+            {
+                if(tokenEnd >= source.length())
+                {
+                    atEnd = true;
+                    return *this;
+                }
+                position = tokenEnd + separator.length();
+                if(position >= source.length())
+                {
+                    // a trailing separator does not start another token
+                    atEnd = true;
+                    return *this;
+                }
+                findTokenEnd();
+                return *this;
+            }
+
+            constexpr Iterator operator++(int)
+            {
+                Iterator previous = *this;
+                ++(*this);
+                return previous;
+            }
+
+            constexpr bool operator==(const Iterator& rhs) const
+            {
+                return atEnd == rhs.atEnd && (atEnd || position == rhs.position);
+            }
+        };
+
+        constexpr TokenRange() = default;
+        constexpr TokenRange(const std::string_view source, const std::string_view separator)
+            : source{source}, separator{separator} { }
+
+        [[nodiscard]] constexpr Iterator begin() const
+        {
+            return Iterator(source, separator);
+        }
+
+        [[nodiscard]] constexpr Iterator end() const
+        {
+            return Iterator();
+        }
+    };
+
+    constexpr SmartStringView::TokenRange SmartStringView::tokens(const SmartStringView& separator) const
+    {
+        return TokenRange(backingView, separator.backingView);
+    }
+}// namespace Utilities
+
+template <>
+inline constexpr bool std::ranges::enable_borrowed_range<Utilities::SmartStringView::TokenRange> = true;
+
+#endif//UTILITYCODE_SMARTSTRINGVIEW_H
@@ -0,0 +1,39 @@
+//
+// The minimal harness shared by the Utility tests: check() records failures instead of stopping,
+// and finish() reports them and gives main its exit status.
+//
+
+#ifndef UTILITYCODE_TESTS_CHECK_H
+#define UTILITYCODE_TESTS_CHECK_H
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace Tests
+{
+    inline int failures = 0;
+
+    inline void check(const bool condition, const std::string& what)
+    {
+        if(!condition)
+        {
+            failures++;
+            std::cerr << "FAILED: " << what << std::endl;
+        }
+    }
+
+    // Prints the outcome of every check so far and returns the exit status for main.
+    inline int finish(const std::string& suite)
+    {
+        if(failures > 0)
+        {
+            std::cerr << failures << " check(s) failed" << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "All " << suite << " checks passed" << std::endl;
+        return EXIT_SUCCESS;
+    }
+}// namespace Tests
+
+#endif//UTILITYCODE_TESTS_CHECK_H
@@ -0,0 +1,179 @@
+//
+// Checks Grid2D and the CharGrid readers against straightforward references.
+//
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <CharGrid.h>
+#include <Grid2D.h>
+
+#include "Check.h"
+
+namespace
+{
+    using Tests::check;
+    using Utilities::Grid2D;
+
+    void testGrid2D()
+    {
+        std::mt19937 random(1);
+        for(int round = 0; round < 50; round++)
+        {
+            const size_t width  = 1 + random() % 9;
+            const size_t height = 1 + random() % 9;
+            Grid2D<int> grid(width, height, -1);
+            const std::string what = "Grid2D " + std::to_string(width) + "x" + std::to_string(height);
+
+            check(grid.getWidth() == width && grid.getHeight() == height && grid.size() == width * height, what + ": dimensions");
+            for(size_t y = 0; y < height; y++)
+            {
+                for(size_t x = 0; x < width; x++)
+                {
+                    grid(x, y) = static_cast<int>(y * width + x);
+                }
+            }
+            for(size_t i = 0; i < grid.size(); i++)
+            {
+                check(grid.data()[i] == static_cast<int>(i), what + ": row-major layout");
+            }
+            for(size_t y = 0; y < height; y++)
+            {
+                check(grid.row(y).size() == width && grid.row(y)[0] == static_cast<int>(y * width), what + ": row " + std::to_string(y));
+            }
+
+            bool threw = false;
+            try
+            {
+                static_cast<void>(grid.at(width, 0));
+            }
+            catch(const std::out_of_range&)
+            {
+                threw = true;
+            }
+            check(threw, what + ": at() outside the grid throws");
+            check(grid.isInBounds(-1, 0) == false && grid.isInBounds(0, static_cast<long long>(height)) == false && grid.isInBounds(0, 0),
+                  what + ": isInBounds");
+
+            for(size_t y = 0; y < height; y++)
+            {
+                for(size_t x = 0; x < width; x++)
+                {
+                    for(const auto neighbourhood : {Utilities::Neighbourhood::Orthogonal, Utilities::Neighbourhood::All})
+                    {
+                        std::set<std::tuple<size_t, size_t, int>> expected;
+                        for(long long dy = -1; dy <= 1; dy++)
+                        {
+                            for(long long dx = -1; dx <= 1; dx++)
+                            {
+                                const long long nx = static_cast<long long>(x) + dx;
+                                const long long ny = static_cast<long long>(y) + dy;
+                                const bool diagonal = dx != 0 && dy != 0;
+                                if((dx == 0 && dy == 0) || (diagonal && neighbourhood == Utilities::Neighbourhood::Orthogonal) ||
+                                   nx < 0 || ny < 0 || nx >= static_cast<long long>(width) || ny >= static_cast<long long>(height))
+                                {
+                                    continue;
+                                }
+                                expected.insert({nx, ny, static_cast<int>(ny * width + nx)});
+                            }
+                        }
+                        std::set<std::tuple<size_t, size_t, int>> visited;
+                        std::as_const(grid).forEachNeighbour(x, y, [&](const size_t nx, const size_t ny, const int cell) {
+                            visited.insert({nx, ny, cell});
+                        }, neighbourhood);
+                        check(visited == expected, what + ": neighbours of (" + std::to_string(x) + ", " + std::to_string(y) + ")");
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<std::string> randomLines(std::mt19937& random)
+    {
+        std::vector<std::string> lines(random() % 8);
+        for(std::string& line : lines)
+        {
+            line.resize(random() % 9);
+            for(char& c : line)
+            {
+                c = ".#0123456789*"[random() % 13];
+            }
+        }
+        return lines;
+    }
+
+    void testCharGrid()
+    {
+        // not a character the lines contain, so padded cells are told apart from read ones
+        constexpr char PADDING = '~';
+        std::mt19937 random(2);
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / ("grid_tests_" + std::to_string(random()) + ".txt");
+        for(int round = 0; round < 300; round++)
+        {
+            const std::vector<std::string> lines = randomLines(random);
+            std::string contents;
+            size_t width = 0;
+            for(const std::string& line : lines)
+            {
+                // trailing whitespace and carriage returns are not part of the grid
+                contents += line + (round % 2 == 0 ? " \r\n" : "\n");
+                width = std::max(width, line.length());
+            }
+            {
+                std::ofstream file(path, std::ios::binary);
+                file << contents;
+            }
+            const std::string what = "grid " + std::to_string(round);
+
+            const Grid2D<char> grid = Utilities::readCharGrid(path.string().c_str(), PADDING);
+            check(grid.getWidth() == width && grid.getHeight() == lines.size(), what + ": readCharGrid dimensions");
+            for(size_t y = 0; y < grid.getHeight(); y++)
+            {
+                for(size_t x = 0; x < width; x++)
+                {
+                    const char expected = x < lines[y].length() ? lines[y][x] : PADDING;
+                    check(grid(x, y) == expected, what + ": readCharGrid cell");
+                }
+            }
+
+            // streaming the same text through a RowWindow shows each row with its neighbours
+            std::istringstream input(contents);
+            Utilities::RowWindow window(PADDING);
+            std::string next;
+            for(size_t y = 0; Utilities::readTrimmedLine(input, next); y++)
+            {
+                check(next == lines[y], what + ": readTrimmedLine");
+                window.push(std::move(next));
+                for(long long x = -1; x <= static_cast<long long>(width); x++)
+                {
+                    for(size_t row = 0; row < 3; row++)
+                    {
+                        const long long lineIndex = static_cast<long long>(y) - 2 + static_cast<long long>(row);
+                        const std::string line = lineIndex < 0 ? "" : lines[lineIndex];
+                        const char expected = x >= 0 && x < static_cast<long long>(line.length()) ? line[x] : PADDING;
+                        check(window.at(row, x) == expected, what + ": RowWindow::at");
+                    }
+                }
+            }
+            check(!Utilities::readTrimmedLine(input, next) && next.empty(), what + ": readTrimmedLine at the end");
+        }
+        std::filesystem::remove(path);
+    }
+}
+
+int main()
+{
+    testGrid2D();
+    testCharGrid();
+
+    return Tests::finish("Grid");
+}
@@ -0,0 +1,310 @@
+//
+// Checks every Set policy and ConcurrentSet against std::set.
+//
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <ConcurrentSet.h>
+#include <Set.h>
+
+#include "Check.h"
+
+namespace
+{
+    using Tests::check;
+
+    // An item whose hashes collide in small groups, so the hashed policy's probing and backward
+    // shift deletion get exercised on long clusters.
+    struct Colliding
+    {
+        int value = 0;
+
+        Colliding() = default;
+        Colliding(const int value) : value{value} { }
+
+        bool operator==(const Colliding& rhs) const
+        {
+            return value == rhs.value;
+        }
+
+        bool operator<(const Colliding& rhs) const
+        {
+            return value < rhs.value;
+        }
+    };
+}
+
+template<>
+struct std::hash<Colliding>
+{
+    size_t operator()(const Colliding& item) const
+    {
+        return static_cast<size_t>(item.value / 8);
+    }
+};
+
+namespace
+{
+    using Utilities::Set;
+
+    // the bitset's iterator returns items by value, so it is only an input iterator to the old-style
+    // algorithms, but still a forward iterator to ranges
+    static_assert(std::forward_iterator<Set<uint8_t>::const_iterator>);
+    static_assert(std::is_same<std::iterator_traits<Set<uint8_t>::const_iterator>::iterator_category, std::input_iterator_tag>::value);
+
+    template<typename T, typename Policy>
+    std::set<T> contentsOf(const Set<T, Policy>& set)
+    {
+        return std::set<T>(set.begin(), set.end());
+    }
+
+    // Checks that set holds exactly expected, through every way of reading it.
+    template<typename T, typename Policy>
+    void checkMatches(const Set<T, Policy>& set, const std::set<T>& expected, const std::string& what)
+    {
+        check(set.size() == static_cast<int>(expected.size()), what + ": size");
+        check(static_cast<int>(std::distance(set.begin(), set.end())) == set.size(), what + ": iteration visits size() items");
+        check(contentsOf(set) == expected, what + ": contents");
+        for(int i = 0; i < set.size(); i++)
+        {
+            check(set.getIndexOf(set[i]) == i, what + ": getIndexOf(operator[])");
+        }
+        for(const T& item : expected)
+        {
+            check(set.contains(item), what + ": contains");
+        }
+    }
+
+    template<typename T, typename Policy>
+    Set<T, Policy> makeSet(const std::set<T>& items)
+    {
+        Set<T, Policy> set;
+        for(const T& item : items)
+        {
+            set.addItem(item);
+        }
+        return set;
+    }
+
+    template<typename T>
+    std::set<T> randomItems(std::mt19937& random, const int maxValue)
+    {
+        std::set<T> items;
+        const int count = static_cast<int>(random() % 60);
+        for(int i = 0; i < count; i++)
+        {
+            items.insert(static_cast<T>(random() % maxValue));
+        }
+        return items;
+    }
+
+    // Random adds and removals, checked step by step against std::set.
+    template<typename T, typename Policy>
+    void testAddRemove(const std::string& name, const int maxValue)
+    {
+        std::mt19937 random(1);
+        Set<T, Policy> set;
+        std::set<T> expected;
+        for(int step = 0; step < 4000; step++)
+        {
+            const T item = static_cast<T>(random() % maxValue);
+            switch(random() % 4)
+            {
+                case 0:
+                case 1:
+                    check(set.addItem(item) == expected.insert(item).second, name + ": addItem result");
+                    break;
+                case 2:
+                    check(set.removeItem(item) == (expected.erase(item) == 1), name + ": removeItem result");
+                    break;
+                default:
+                    check(set.contains(item) == (expected.count(item) == 1), name + ": contains");
+                    break;
+            }
+            if(step % 500 == 0)
+            {
+                checkMatches(set, expected, name + " after random edits");
+            }
+        }
+        checkMatches(set, expected, name + " after random edits");
+
+        while(set.size() > 0)
+        {
+            const T item = set[0];
+            check(set.removeAt(0), name + ": removeAt");
+            expected.erase(item);
+        }
+        checkMatches(set, expected, name + " after removeAt");
+        check(!set.removeAt(0), name + ": removeAt on an empty set");
+
+        if constexpr(std::is_integral<T>::value)
+        {
+            // removeItem(1) removes the item 1, not the item at index 1
+            set.addItem(static_cast<T>(1));
+            set.addItem(static_cast<T>(3));
+            check(set.removeValue(static_cast<T>(1)) && set.contains(static_cast<T>(3)) && !set.contains(static_cast<T>(1)), name + ": removeValue");
+            set.addItem(static_cast<T>(1));
+            check(set.removeItem(1) && set.contains(static_cast<T>(3)) && !set.contains(static_cast<T>(1)), name + ": removeItem of an integer");
+        }
+    }
+
+    template<typename T, typename Policy>
+    void testAlgebra(const std::string& name, const int maxValue)
+    {
+        std::mt19937 random(2);
+        for(int round = 0; round < 300; round++)
+        {
+            const std::set<T> left  = randomItems<T>(random, maxValue);
+            const std::set<T> right = randomItems<T>(random, maxValue);
+            const Set<T, Policy> a  = makeSet<T, Policy>(left);
+            const Set<T, Policy> b  = makeSet<T, Policy>(right);
+
+            std::set<T> unionItems;
+            std::set<T> intersectionItems;
+            std::set<T> differenceItems;
+            std::set<T> complementItems;
+            std::set_union(left.begin(), left.end(), right.begin(), right.end(), std::inserter(unionItems, unionItems.end()));
+            std::set_intersection(left.begin(), left.end(), right.begin(), right.end(), std::inserter(intersectionItems, intersectionItems.end()));
+            std::set_difference(left.begin(), left.end(), right.begin(), right.end(), std::inserter(differenceItems, differenceItems.end()));
+            std::set_symmetric_difference(left.begin(), left.end(), right.begin(), right.end(), std::inserter(complementItems, complementItems.end()));
+
+            checkMatches(a.Union(b), unionItems, name + ": Union");
+            checkMatches(a + b, unionItems, name + ": operator+");
+            checkMatches(a.Intersection(b), intersectionItems, name + ": Intersection");
+            checkMatches(a.Complement(b), complementItems, name + ": Complement");
+            checkMatches(a - b, complementItems, name + ": operator-");
+
+            Set<T, Policy> inPlace = a;
+            checkMatches(inPlace.unionWith(b), unionItems, name + ": unionWith");
+            inPlace = a;
+            checkMatches(inPlace.intersectWith(b), intersectionItems, name + ": intersectWith");
+            inPlace = a;
+            checkMatches(inPlace.subtract(b), differenceItems, name + ": subtract");
+            inPlace = a;
+            checkMatches(inPlace += b, unionItems, name + ": operator+=");
+            inPlace = a;
+            checkMatches(inPlace -= b, complementItems, name + ": operator-=");
+            inPlace = a;
+            checkMatches(inPlace.subtract(inPlace), std::set<T>(), name + ": subtract itself");
+
+            const bool subset = std::includes(right.begin(), right.end(), left.begin(), left.end());
+            check(a.isSubSetOf(b) == subset, name + ": isSubSetOf");
+            check(b.isSuperSetOf(a) == subset, name + ": isSuperSetOf");
+            check(a.Intersection(b).isSubSetOf(a), name + ": an intersection is a subset");
+            check((a == b) == (left == right), name + ": operator==");
+            check(a == makeSet<T, Policy>(left), name + ": operator== on equal sets");
+
+            Set<T, Policy> moved = a;
+            Set<T, Policy> target(std::move(moved));
+            checkMatches(target, left, name + ": move construction");
+            Set<T, Policy> assigned;
+            assigned = a.Union(b);
+            checkMatches(assigned, unionItems, name + ": move assignment");
+        }
+    }
+
+    template<typename T, typename Policy>
+    void testPolicy(const std::string& name, const int maxValue)
+    {
+        testAddRemove<T, Policy>(name, maxValue);
+        testAlgebra<T, Policy>(name, maxValue);
+    }
+
+    // Several threads add overlapping ranges and remove part of them, then the snapshot must hold
+    // exactly what is left.
+    template<typename Policy>
+    void testConcurrentSet(const std::string& name)
+    {
+        constexpr int ITEMS_PER_THREAD = 20000;
+        for(const int numThreads : {1, 2, 4, 8})
+        {
+            Utilities::ConcurrentSet<int, Policy> set(16);
+            std::vector<std::thread> threads;
+            for(int t = 0; t < numThreads; t++)
+            {
+                threads.emplace_back([&set, t] {
+                    // each thread's range overlaps the next thread's by half
+                    const int first = t * ITEMS_PER_THREAD / 2;
+                    for(int item = first; item < first + ITEMS_PER_THREAD; item++)
+                    {
+                        set.addItem(item);
+                    }
+                    for(int item = first; item < first + ITEMS_PER_THREAD; item += 3)
+                    {
+                        set.removeItem(item);
+                        set.contains(item + 1);
+                    }
+                });
+            }
+            for(std::thread& thread : threads)
+            {
+                thread.join();
+            }
+
+            // every removal happens after the owning thread's own adds, but a neighbour may add an
+            // overlapping item back later, so only items no thread removes are certain
+            std::set<int> added;
+            std::set<int> removed;
+            for(int t = 0; t < numThreads; t++)
+            {
+                const int first = t * ITEMS_PER_THREAD / 2;
+                for(int item = first; item < first + ITEMS_PER_THREAD; item++)
+                {
+                    added.insert(item);
+                    if((item - first) % 3 == 0)
+                    {
+                        removed.insert(item);
+                    }
+                }
+            }
+
+            const std::string what = name + " with " + std::to_string(numThreads) + " threads";
+            const auto snapshot = set.snapshot();
+            check(snapshot.size() == set.size(), what + ": snapshot size matches size()");
+            for(const int item : snapshot)
+            {
+                check(added.count(item) == 1, what + ": snapshot only holds added items");
+                check(set.contains(item), what + ": contains agrees with the snapshot");
+            }
+            for(const int item : added)
+            {
+                if(removed.count(item) == 0)
+                {
+                    check(snapshot.contains(item), what + ": items nobody removed survive");
+                }
+            }
+            if(numThreads == 1)
+            {
+                std::set<int> expected;
+                std::set_difference(added.begin(), added.end(), removed.begin(), removed.end(), std::inserter(expected, expected.end()));
+                checkMatches(snapshot, expected, what + ": snapshot");
+            }
+        }
+    }
+}
+
+int main()
+{
+    testPolicy<int, Utilities::LinearSetPolicy>("LinearSetPolicy", 120);
+    testPolicy<int, Utilities::HashedSetPolicy>("HashedSetPolicy", 120);
+    testPolicy<int, Utilities::HashedSetPolicy>("HashedSetPolicy (wide range)", 1000000);
+    testPolicy<Colliding, Utilities::HashedSetPolicy>("HashedSetPolicy (colliding hashes)", 400);
+    testPolicy<int, Utilities::SortedSetPolicy>("SortedSetPolicy", 120);
+    testPolicy<Colliding, Utilities::SortedSetPolicy>("SortedSetPolicy (custom type)", 400);
+    testPolicy<int, Utilities::BitsetPolicy<300>>("BitsetPolicy<300>", 300);
+    testPolicy<uint8_t, Utilities::DefaultSetPolicy<uint8_t>>("Set<uint8_t>", 256);
+
+    testConcurrentSet<Utilities::HashedSetPolicy>("ConcurrentSet");
+    testConcurrentSet<Utilities::SortedSetPolicy>("ConcurrentSet (sorted shards)");
+
+    return Tests::finish("Set");
+}
@@ -0,0 +1,804 @@
+//
+// Checks the SmartString building blocks against scalar or std:: references.
+//
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include <AsciiKernels.h>
+#include <CharacterSet.h>
+#include <MappedFile.h>
+#include <MultiPatternMatcher.h>
+#include <ParallelLineSum.h>
+#include <SmartString.h>
+#include <SmartStringView.h>
+
+#include "Check.h"
+
+namespace
+{
+    using Tests::check;
+    using Utilities::AsciiClass;
+    using Utilities::AsciiKernels;
+    using Utilities::CharacterSet;
+    using Utilities::MultiPatternMatcher;
+    using Utilities::SmartString;
+    using Utilities::SmartStringView;
+
+    // length random bytes drawn from alphabet, or from all 256 byte values when it is empty.
+    std::string randomText(std::mt19937& random, const size_t length, const std::string_view alphabet = "")
+    {
+        std::string text(length, '\0');
+        for(char& c : text)
+        {
+            c = alphabet.empty() ? static_cast<char>(random() % 256) : alphabet[random() % alphabet.length()];
+        }
+        return text;
+    }
+
+    // The <cctype> (C locale) meaning of each AsciiClass, which the kernels must agree with.
+    bool referenceIsInClass(const char c, const AsciiClass classes)
+    {
+        const auto byte = static_cast<unsigned char>(c);
+        return (Utilities::hasAnyOf(classes, AsciiClass::Digit) && std::isdigit(byte)) ||
+               (Utilities::hasAnyOf(classes, AsciiClass::Upper) && std::isupper(byte)) ||
+               (Utilities::hasAnyOf(classes, AsciiClass::Lower) && std::islower(byte)) ||
+               (Utilities::hasAnyOf(classes, AsciiClass::Whitespace) && std::isspace(byte)) ||
+               (Utilities::hasAnyOf(classes, AsciiClass::Punctuation) && std::ispunct(byte));
+    }
+
+    std::string instructionSetName(const AsciiKernels::InstructionSet instructionSet)
+    {
+        switch(instructionSet)
+        {
+            case AsciiKernels::InstructionSet::AVX2: return "AVX2";
+            case AsciiKernels::InstructionSet::SSE2: return "SSE2";
+            default:                                 return "Scalar";
+        }
+    }
+
+    void testAsciiKernels(const std::string& name)
+    {
+        std::mt19937 random(1);
+        const AsciiClass classLists[] = {AsciiClass::Digit, AsciiClass::Upper, AsciiClass::Lower, AsciiClass::Whitespace,
+                                         AsciiClass::Punctuation, AsciiClass::Alpha, AsciiClass::Alphanumeric,
+                                         AsciiClass::Digit | AsciiClass::Whitespace, AsciiClass::None};
+        for(int round = 0; round < 400; round++)
+        {
+            // lengths around the 16 and 32 byte blocks matter most, so most texts are short
+            const size_t length = round % 10 == 0 ? random() % 2000 : random() % 100;
+            const std::string text = randomText(random, length, round % 2 == 0 ? "" : "aZ09 .\t-_qQ");
+            const std::string what = name + " on " + std::to_string(length) + " bytes";
+
+            std::string upper = text;
+            std::string lower = text;
+            AsciiKernels::toUpper(upper.data(), upper.length());
+            AsciiKernels::toLower(lower.data(), lower.length());
+            std::string expectedUpper = text;
+            std::string expectedLower = text;
+            for(size_t i = 0; i < text.length(); i++)
+            {
+                const auto byte = static_cast<unsigned char>(text[i]);
+                if(byte < 128)
+                {
+                    expectedUpper[i] = static_cast<char>(std::toupper(byte));
+                    expectedLower[i] = static_cast<char>(std::tolower(byte));
+                }
+            }
+            check(upper == expectedUpper, what + ": toUpper");
+            check(lower == expectedLower, what + ": toLower");
+
+            for(const AsciiClass classes : classLists)
+            {
+                const std::vector<uint64_t> mask = AsciiKernels::classMask(text.data(), text.length(), classes);
+                std::vector<uint64_t> expectedMask((text.length() + 63) / 64, 0);
+                std::string expectedExtract;
+                size_t expectedFirst = text.length();
+                size_t expectedLast  = text.length();
+                for(size_t i = 0; i < text.length(); i++)
+                {
+                    if(referenceIsInClass(text[i], classes))
+                    {
+                        expectedMask[i / 64] |= uint64_t{1} << (i % 64);
+                        expectedExtract += text[i];
+                        expectedFirst = std::min(expectedFirst, i);
+                        expectedLast  = i;
+                    }
+                }
+                const std::string classWhat = what + ", classes " + std::to_string(static_cast<int>(classes));
+                check(mask == expectedMask, classWhat + ": classMask");
+                check(AsciiKernels::findFirst(text.data(), text.length(), classes) == expectedFirst, classWhat + ": findFirst");
+                check(AsciiKernels::findLast(text.data(), text.length(), classes) == expectedLast, classWhat + ": findLast");
+
+                std::string extracted(text.length(), '\0');
+                extracted.resize(AsciiKernels::extract(text.data(), text.length(), classes, extracted.data()));
+                check(extracted == expectedExtract, classWhat + ": extract");
+            }
+
+            std::string translated = text;
+            AsciiKernels::translate(translated.data(), translated.length(), AsciiKernels::createTranslationTable("aZ ", "zA_"));
+            std::string expectedTranslated = text;
+            std::replace(expectedTranslated.begin(), expectedTranslated.end(), 'a', '\x01');
+            std::replace(expectedTranslated.begin(), expectedTranslated.end(), 'Z', 'A');
+            std::replace(expectedTranslated.begin(), expectedTranslated.end(), ' ', '_');
+            std::replace(expectedTranslated.begin(), expectedTranslated.end(), '\x01', 'z');
+            if(text.find('\x01') == std::string::npos)
+            {
+                check(translated == expectedTranslated, what + ": translate");
+            }
+        }
+    }
+
+    void testAsciiKernelsOnEveryInstructionSet()
+    {
+        const AsciiKernels::InstructionSet widest = AsciiKernels::instructionSet();
+        for(const auto instructionSet : {AsciiKernels::InstructionSet::AVX2, AsciiKernels::InstructionSet::SSE2, AsciiKernels::InstructionSet::Scalar})
+        {
+            if(instructionSet > widest)
+            {
+                std::cout << "Skipping the " << instructionSetName(instructionSet) << " kernels, which this CPU does not support" << std::endl;
+                continue;
+            }
+            AsciiKernels::limitInstructionSet(instructionSet);
+            check(AsciiKernels::instructionSet() == instructionSet, "limitInstructionSet(" + instructionSetName(instructionSet) + ")");
+            testAsciiKernels("AsciiKernels (" + instructionSetName(instructionSet) + ")");
+
+            SmartString text("Mixed CASE text, 123 of it, long enough to cover a full AVX2 block!");
+            check(SmartString(text).toUpper().str() == "MIXED CASE TEXT, 123 OF IT, LONG ENOUGH TO COVER A FULL AVX2 BLOCK!",
+                  instructionSetName(instructionSet) + ": SmartString::toUpper");
+            check(text.extractDigits().str() == "1232", instructionSetName(instructionSet) + ": SmartString::extractDigits");
+        }
+        AsciiKernels::limitInstructionSet(widest);
+    }
+
+    // The documented tokenizing rule: a leading separator gives an empty token, a trailing one does not.
+    std::vector<std::string> referenceTokens(const std::string& text, const std::string& separator)
+    {
+        std::vector<std::string> tokens;
+        size_t position = 0;
+        while(position < text.length())
+        {
+            const size_t location = separator.empty() ? std::string::npos : text.find(separator, position);
+            if(location == std::string::npos)
+            {
+                tokens.push_back(text.substr(position));
+                break;
+            }
+            tokens.push_back(text.substr(position, location - position));
+            position = location + separator.length();
+        }
+        return tokens;
+    }
+
+    void testSplit()
+    {
+        std::mt19937 random(10);
+        for(int round = 0; round < 3000; round++)
+        {
+            const std::string text      = randomText(random, random() % 30, "ab, ");
+            const std::string separator = randomText(random, random() % 3, ", ");
+            const std::string what      = "split(\"" + separator + "\") of \"" + text + "\"";
+            const std::vector<std::string> expected = referenceTokens(text, separator);
+
+            // views into the source, so every token's characters are the source's own
+            const SmartStringView source(text);
+            const std::vector<SmartStringView> views = source.split(separator);
+            std::vector<std::string> actual;
+            bool zeroCopy = true;
+            for(const SmartStringView token : views)
+            {
+                actual.push_back(token.str());
+                zeroCopy = zeroCopy && token.data() >= text.data() && token.data() + token.length() <= text.data() + text.length();
+            }
+            check(actual == expected, what + ": SmartStringView::split");
+            check(zeroCopy, what + ": SmartStringView::split points into the source");
+
+            std::vector<std::string> owned;
+            for(const SmartString& token : SmartString(text).split<SmartString>(separator))
+            {
+                owned.push_back(token.str());
+            }
+            check(owned == expected, what + ": SmartString::split");
+        }
+    }
+
+    void testTokens()
+    {
+        std::mt19937 random(4);
+        for(int round = 0; round < 3000; round++)
+        {
+            const std::string text      = randomText(random, random() % 30, "ab, ");
+            const std::string separator = randomText(random, random() % 3, ", ");
+            const std::string what      = "tokens(\"" + separator + "\") of \"" + text + "\"";
+            const std::vector<std::string> expected = referenceTokens(text, separator);
+
+            const SmartString owner(text);
+            std::vector<std::string> lazy;
+            for(const SmartStringView token : owner.tokens(separator))
+            {
+                lazy.push_back(token.str());
+            }
+            check(lazy == expected, what);
+
+            std::vector<std::string> split;
+            for(const SmartString& token : owner.split<SmartString>(separator))
+            {
+                split.push_back(token.str());
+            }
+            check(split == expected, what + " matches split");
+
+            std::vector<std::string> taken;
+            for(const SmartStringView token : owner.tokens(separator) | std::views::take(2))
+            {
+                taken.push_back(token.str());
+            }
+            check(taken == std::vector<std::string>(expected.begin(), expected.begin() + std::min<size_t>(2, expected.size())), what + " | take(2)");
+        }
+    }
+
+    // The number tryConvert must produce for text, worked out with a regex and std:: parsing.
+    template <typename T>
+    bool referenceConvert(const std::string& text, T& out)
+    {
+        static const std::regex NUMBER(R"(-?[0-9]*(\.[0-9]*)?)");
+        if(text.empty() || text == "-" || !std::regex_match(text, NUMBER))
+        {
+            return false;
+        }
+        const bool isNegative = text.front() == '-';
+        const std::string digits = text.substr(isNegative ? 1 : 0);
+        if constexpr(std::is_floating_point<T>::value)
+        {
+            if(digits == ".")
+            {
+                out = 0;
+                return true;
+            }
+            out = std::is_same<T, float>::value ? std::strtof(text.c_str(), nullptr) : std::strtod(text.c_str(), nullptr);
+            return true;
+        }
+        else
+        {
+            const std::string whole = digits.substr(0, digits.find('.'));
+            __int128 value = 0;
+            for(const char c : whole)
+            {
+                value = value * 10 + (c - '0');
+                if(value > static_cast<__int128>(std::numeric_limits<uint64_t>::max()))
+                {
+                    return false;
+                }
+            }
+            if(isNegative)
+            {
+                value = -value;
+            }
+            if(value < static_cast<__int128>(std::numeric_limits<T>::min()) || value > static_cast<__int128>(std::numeric_limits<T>::max()))
+            {
+                return false;
+            }
+            out = static_cast<T>(value);
+            return true;
+        }
+    }
+
+    template <typename T>
+    void testTryConvert(const std::string& name, std::mt19937& random)
+    {
+        std::vector<std::string> texts = {"", "-", ".", "-.", "0", "-0", "007", "1.", ".5", "-1.5", "1.2.3", "--1", "1-", "+1", "1e5", " 1",
+                                          "9223372036854775807", "-9223372036854775808", "9223372036854775808", "18446744073709551615",
+                                          "18446744073709551616", "2147483647", "-2147483648", "2147483648", "4294967295", "4294967296"};
+        for(int i = 0; i < 2000; i++)
+        {
+            texts.push_back(randomText(random, random() % 22, i % 4 == 0 ? "0123456789.-x" : "0123456789"));
+            if(i % 2 == 0)
+            {
+                texts.back().insert(0, "-");
+            }
+        }
+        for(const std::string& text : texts)
+        {
+            T actual   = 0;
+            T expected = 0;
+            const bool parsed = SmartStringView(text).tryConvert(actual);
+            const bool valid  = referenceConvert(text, expected);
+            check(parsed == valid, name + ": whether \"" + text + "\" parses");
+            if(parsed && valid)
+            {
+                check(actual == expected, name + ": value of \"" + text + "\"");
+            }
+            T fromSmartString = 0;
+            check(SmartString::tryConvert(SmartString(text), fromSmartString) == valid && (!valid || fromSmartString == expected),
+                  name + ": SmartString::tryConvert of \"" + text + "\"");
+        }
+    }
+
+    void testTryConvert()
+    {
+        std::mt19937 random(5);
+        testTryConvert<int>("tryConvert<int>", random);
+        testTryConvert<long long>("tryConvert<long long>", random);
+        testTryConvert<unsigned int>("tryConvert<unsigned int>", random);
+        testTryConvert<uint64_t>("tryConvert<uint64_t>", random);
+        testTryConvert<double>("tryConvert<double>", random);
+        testTryConvert<float>("tryConvert<float>", random);
+    }
+
+    // every Searcher algorithm, each of which must agree with std::string::find
+    const SmartString::Searcher::Algorithm ALGORITHMS[] = {SmartString::Searcher::Algorithm::Automatic, SmartString::Searcher::Algorithm::KnuthMorrisPratt,
+                                                           SmartString::Searcher::Algorithm::BoyerMooreHorspool, SmartString::Searcher::Algorithm::BoyerMoore,
+                                                           SmartString::Searcher::Algorithm::TwoByteFilter};
+
+    void testReplaceAll()
+    {
+        std::mt19937 random(9);
+        for(int round = 0; round < 600; round++)
+        {
+            const size_t haystackLength = round % 8 == 0 ? 5000 + random() % 3000 : random() % 300;
+            const std::string_view alphabet = round % 3 == 0 ? "ab" : "abcd";
+            const std::string haystack    = randomText(random, haystackLength, alphabet);
+            const std::string pattern     = randomText(random, 1 + random() % (round % 5 == 0 ? 40 : 6), alphabet);
+            const std::string replacement = randomText(random, random() % 8, "xy");
+
+            // non-overlapping matches, left to right, with no rescanning of replaced text
+            std::string expected;
+            size_t copiedUpTo = 0;
+            for(size_t location = haystack.find(pattern); location != std::string::npos; location = haystack.find(pattern, location + pattern.length()))
+            {
+                expected += haystack.substr(copiedUpTo, location - copiedUpTo) + replacement;
+                copiedUpTo = location + pattern.length();
+            }
+            expected += haystack.substr(copiedUpTo);
+            for(const auto algorithm : ALGORITHMS)
+            {
+                const std::string what = "replaceAll (algorithm " + std::to_string(static_cast<int>(algorithm)) + ") of \"" + pattern + "\" in " +
+                                         std::to_string(haystack.length()) + " bytes";
+                const SmartString::Searcher searcher(SmartString(pattern), algorithm);
+                check(SmartString(haystack).replaceAll(searcher, SmartString(replacement)).str() == expected, what);
+            }
+            check(SmartString(haystack).replaceAll(pattern, replacement).str() == expected, "replaceAll(\"" + pattern + "\", \"" + replacement + "\")");
+        }
+
+        SmartString aliased("abcab");
+        aliased.replaceAll(SmartString::Searcher(SmartString("ab")), aliased);
+        check(aliased.str() == "abcabcabcab", "replaceAll with the string itself as the replacement");
+        check(SmartString("aabb").removeAll("ab").str() == "ab", "removeAll does not rescan joined text");
+    }
+
+    void testSearcher()
+    {
+        using Algorithm = SmartString::Searcher::Algorithm;
+        std::mt19937 random(3);
+
+        check(SmartString::Searcher(SmartString("x")).getAlgorithm() == Algorithm::TwoByteFilter, "Searcher picks memchr for one byte");
+        check(SmartString::Searcher(SmartString("xyz")).getAlgorithm() == Algorithm::KnuthMorrisPratt, "Searcher picks KMP for short patterns");
+        check(SmartString::Searcher(SmartString(std::string(40, 'x'))).getAlgorithm() == Algorithm::BoyerMooreHorspool,
+              "Searcher picks Boyer-Moore-Horspool for long patterns");
+
+        for(int round = 0; round < 600; round++)
+        {
+            // some haystacks are past MEMCHR_SEARCH_THRESHOLD, so automatic searches switch algorithm
+            const size_t haystackLength = round % 8 == 0 ? SmartString::Searcher::MEMCHR_SEARCH_THRESHOLD + random() % 3000 : random() % 300;
+            const std::string_view alphabet = round % 3 == 0 ? "ab" : "abcd";
+            const std::string haystack = randomText(random, haystackLength, alphabet);
+            const std::string pattern  = randomText(random, 1 + random() % (round % 5 == 0 ? 40 : 6), alphabet);
+            for(const Algorithm algorithm : ALGORITHMS)
+            {
+                const SmartString::Searcher searcher(SmartString(pattern), algorithm);
+                const std::string what = "Searcher (algorithm " + std::to_string(static_cast<int>(algorithm)) + ") for \"" + pattern + "\" in " +
+                                         std::to_string(haystack.length()) + " bytes";
+                for(int start = 0; start < 6; start++)
+                {
+                    const size_t position = start == 0 ? 0 : random() % (haystack.length() + 2);
+                    if(searcher.find(haystack, position) != haystack.find(pattern, position))
+                    {
+                        check(false, what + ": find from " + std::to_string(position));
+                    }
+                }
+
+                unsigned int expectedCount = 0;
+                for(size_t location = haystack.find(pattern); location != std::string::npos; location = haystack.find(pattern, location + 1))
+                {
+                    expectedCount++;
+                }
+                check(SmartString(haystack).count(searcher) == expectedCount, what + ": count");
+            }
+        }
+    }
+
+    // {N} replaced by values[N] where there is one, without rescanning substituted text.
+    std::string referenceFormat(const std::string& pattern, const std::vector<std::string>& values)
+    {
+        static const std::regex ARGUMENT(R"(\{([0-9]+)\})");
+        std::string result;
+        auto copiedUpTo = pattern.cbegin();
+        for(std::sregex_iterator match(pattern.begin(), pattern.end(), ARGUMENT), end; match != end; ++match)
+        {
+            result.append(copiedUpTo, (*match)[0].first);
+            const std::string& number = (*match)[1].str();
+            const size_t argument = number.length() < 6 ? std::stoul(number) : values.size();
+            result += argument < values.size() ? values[argument] : (*match)[0].str();
+            copiedUpTo = (*match)[0].second;
+        }
+        result.append(copiedUpTo, pattern.cend());
+        return result;
+    }
+
+    void testFormat()
+    {
+        std::mt19937 random(6);
+        for(int round = 0; round < 2000; round++)
+        {
+            const std::string pattern = randomText(random, random() % 25, "{}0123a ");
+            const std::vector<std::string> values = {"x", "{1}", "zz"};
+            const std::string expected = referenceFormat(pattern, values);
+            const std::string what     = "format of \"" + pattern + "\"";
+
+            check(SmartString::compileFormat(pattern).render("x", "{1}", "zz").str() == expected, what + ": FormatTemplate::render");
+            check(SmartString(pattern).format("x", "{1}", "zz").str() == expected, what + ": SmartString::format");
+            check(SmartString::format<std::string>(pattern, "x", "{1}", "zz") == expected, what + ": static format");
+        }
+
+        check(SmartString::format<"{0} + {1} = {2}">(1, 2, "three").str() == "1 + 2 = three", "format<> with three arguments");
+        check(SmartString::format<"{1}{0}{1}">("a", "b").str() == "bab", "format<> with repeated arguments");
+        check(SmartString::format<"no arguments {x}">().str() == "no arguments {x}", "format<> without arguments");
+        check(SmartString::compileFormat("{0}{12}").getNumArguments() == 13, "FormatTemplate::getNumArguments");
+    }
+
+    template <typename T>
+    std::string toChars(const T val, const std::chars_format format, const int valPrecision)
+    {
+        std::string text(400, '\0');
+        const auto result = std::to_chars(text.data(), text.data() + text.length(), val, format, valPrecision);
+        text.resize(static_cast<size_t>(result.ptr - text.data()));
+        return text;
+    }
+
+    template <typename T>
+    std::string toChars(const T val, const std::chars_format format)
+    {
+        std::string text(400, '\0');
+        const auto result = std::to_chars(text.data(), text.data() + text.length(), val, format);
+        text.resize(static_cast<size_t>(result.ptr - text.data()));
+        return text;
+    }
+
+    // The documented append(val) rule: the shortest form when it has at most valPrecision decimals,
+    // otherwise rounded to valPrecision with trailing zeroes dropped, and always a digit after the point.
+    template <typename T>
+    std::string referenceAppend(const T val, const int valPrecision)
+    {
+        const std::string shortest = toChars(val, std::chars_format::fixed);
+        const size_t decimal = shortest.find('.');
+        if(decimal == std::string::npos)
+        {
+            return std::isfinite(val) ? shortest + ".0" : shortest;
+        }
+        if(shortest.length() - decimal - 1 <= static_cast<size_t>(valPrecision))
+        {
+            return shortest;
+        }
+        std::string rounded = toChars(val, std::chars_format::fixed, valPrecision);
+        while(rounded.back() == '0')
+        {
+            rounded.pop_back();
+        }
+        return rounded.back() == '.' ? rounded + "0" : rounded;
+    }
+
+    template <typename T>
+    void testAppendFloatingPoint(const std::string& name, std::mt19937& random)
+    {
+        std::vector<T> values = {T(0), -T(0), T(1), T(-1), T(0.5), T(0.1), T(1) / T(3), T(2.5), T(-2.5), T(123456.789), T(1e-7), T(-1e-7),
+                                 T(1e30), std::numeric_limits<T>::max(), std::numeric_limits<T>::lowest(), std::numeric_limits<T>::denorm_min(),
+                                 std::numeric_limits<T>::infinity(), -std::numeric_limits<T>::infinity()};
+        std::uniform_real_distribution<T> fraction(-1000, 1000);
+        std::uniform_int_distribution<int> exponent(-12, 12);
+        for(int i = 0; i < 500; i++)
+        {
+            values.push_back(i % 2 == 0 ? fraction(random) : std::ldexp(fraction(random), exponent(random)));
+        }
+        for(const T val : values)
+        {
+            for(int valPrecision = 0; valPrecision < 12; valPrecision++)
+            {
+                const std::string what = name + " " + toChars(val, std::chars_format::general) + " at precision " + std::to_string(valPrecision);
+
+                // the prefix makes sure only the appended characters are rounded and trimmed
+                SmartString fixed("x=");
+                fixed.append(val, static_cast<unsigned int>(valPrecision));
+                const std::string expectedFixed = toChars(val, std::chars_format::fixed, valPrecision) + (valPrecision == 0 && std::isfinite(val) ? "." : "");
+                check(fixed.str() == "x=" + expectedFixed, what + ": append(val, precision)");
+
+                SmartString shortest("x=");
+                shortest.setPrecision(valPrecision);
+                shortest.append(val);
+                check(shortest.str() == "x=" + referenceAppend(val, shortest.getPrecision()), what + ": append(val)");
+            }
+        }
+    }
+
+    void testAppendNumber()
+    {
+        std::mt19937 random(11);
+        std::vector<long long> integers = {0, 1, -1, 9, 10, -10, std::numeric_limits<int>::max(), std::numeric_limits<int>::min(),
+                                           std::numeric_limits<long long>::max(), std::numeric_limits<long long>::min()};
+        for(int i = 0; i < 500; i++)
+        {
+            const long long magnitude = static_cast<long long>(random() >> 1) * static_cast<long long>(random() >> 1) >> (random() % 60);
+            integers.push_back(i % 2 == 0 ? magnitude : -magnitude);
+        }
+        for(const long long val : integers)
+        {
+            std::string expected(32, '\0');
+            expected.resize(static_cast<size_t>(std::to_chars(expected.data(), expected.data() + expected.length(), val).ptr - expected.data()));
+            check((SmartString("n=") + val).str() == "n=" + expected, "append(long long) " + expected);
+            if(val >= std::numeric_limits<int>::min() && val <= std::numeric_limits<int>::max())
+            {
+                check(SmartString("n=").append(static_cast<int>(val)).str() == "n=" + expected, "append(int) " + expected);
+            }
+        }
+        check(SmartString().append(std::numeric_limits<unsigned long long>::max()).str() == "18446744073709551615", "append(unsigned long long)");
+        check(SmartString().append(4294967295u).str() == "4294967295", "append(unsigned int)");
+
+        testAppendFloatingPoint<double>("append(double)", random);
+        testAppendFloatingPoint<float>("append(float)", random);
+
+        // wider than the first attempt's room, so the text has to grow
+        check(SmartString().append(1e300, 20).str() == toChars(1e300, std::chars_format::fixed, 20), "append of a 320 character number");
+    }
+
+    void testCharacterSet()
+    {
+        std::mt19937 random(2);
+        for(int round = 0; round < 2000; round++)
+        {
+            // up to 8 members take the SSE2 path, more fall back to the bitmap alone
+            const std::string members = randomText(random, 1 + random() % 14, "ab \t.-xyz0123");
+            const CharacterSet set(members);
+            const std::string text = randomText(random, random() % 80, "ab \t.-xyz0123QR");
+            const std::string what = "CharacterSet \"" + members + "\" on \"" + text + "\"";
+
+            const size_t firstOutside = text.find_first_not_of(members);
+            const size_t lastOutside  = text.find_last_not_of(members);
+            check(set.countLeading(text) == (firstOutside == std::string::npos ? text.length() : firstOutside), what + ": countLeading");
+            check(set.countTrailing(text) == (lastOutside == std::string::npos ? text.length() : text.length() - lastOutside - 1), what + ": countTrailing");
+            check(set.size() == std::set<char>(members.begin(), members.end()).size(), what + ": size");
+            for(int c = 0; c < 256; c++)
+            {
+                if(set.contains(static_cast<char>(c)) != (members.find(static_cast<char>(c)) != std::string::npos))
+                {
+                    check(false, what + ": contains " + std::to_string(c));
+                }
+            }
+
+            SmartString stripped(text);
+            stripped.strip(set);
+            const size_t leading = text.find_first_not_of(members);
+            const std::string expected = leading == std::string::npos ? "" : text.substr(leading, lastOutside - leading + 1);
+            check(stripped.str() == expected, what + ": SmartString::strip");
+        }
+    }
+
+    bool isInside(const char* pointer, const std::span<const std::byte> buffer)
+    {
+        const auto* byte = reinterpret_cast<const std::byte*>(pointer);
+        return byte >= buffer.data() && byte < buffer.data() + buffer.size();
+    }
+
+    void testArena()
+    {
+        // longer than any short string buffer, so each string really allocates
+        const std::string text = "a string that is far too long to be stored inside the SmartString object";
+
+        alignas(std::max_align_t) std::array<std::byte, 1024> buffer{};
+        SmartString::Arena arena{std::span<std::byte>(buffer)};
+
+        SmartString first(text, arena.getAllocator());
+        check(first.getAllocator().resource() == arena.getResource(), "Arena: strings made with its allocator use its resource");
+        check(isInside(first.view().data(), buffer), "Arena: allocations come from the buffer first");
+        const char* firstLocation = first.view().data();
+
+        // everything derived from an Arena string stays in the Arena
+        const std::vector<SmartString> tokens = first.split<SmartString>(" ");
+        bool tokensInArena = !tokens.empty();
+        for(const SmartString& token : tokens)
+        {
+            tokensInArena = tokensInArena && token.getAllocator().resource() == arena.getResource();
+        }
+        check(tokensInArena, "Arena: split propagates the allocator");
+        check(first.getSubstring(0, 39).getAllocator().resource() == arena.getResource(), "Arena: getSubstring propagates the allocator");
+        check((first + "!").getAllocator().resource() == arena.getResource(), "Arena: operator+ propagates the allocator");
+        check(first.getSubstring(0, 39).str() == text.substr(0, 40), "Arena: getSubstring contents");
+
+        // past the end of the buffer allocations fall back to the heap, and the strings stay intact
+        std::vector<SmartString> many;
+        for(int i = 0; i < 40; i++)
+        {
+            many.emplace_back(text, arena.getAllocator());
+        }
+        check(!isInside(many.back().view().data(), buffer), "Arena: falls back to the heap once the buffer is full");
+        bool intact = true;
+        for(const SmartString& string : many)
+        {
+            intact = intact && string.str() == text;
+        }
+        check(intact && first.str() == text, "Arena: strings keep their contents across the heap fallback");
+
+        // release() hands the whole buffer back, so the next string starts where the first one did
+        many.clear();
+        arena.release();
+        SmartString reused(text, arena.getAllocator());
+        check(reused.view().data() == firstLocation, "Arena: release() reuses the buffer from the start");
+        check(reused.str() == text, "Arena: contents after release()");
+
+        SmartString unrelated(text);
+        check(unrelated.getAllocator().resource() == std::pmr::get_default_resource(), "SmartStrings without an Arena use the default resource");
+    }
+
+    void testMultiPatternMatcher()
+    {
+        using Match = MultiPatternMatcher::Match;
+        std::mt19937 random(7);
+        for(int round = 0; round < 1500; round++)
+        {
+            std::set<std::string> unique;
+            const size_t numPatterns = 1 + random() % 6;
+            while(unique.size() < numPatterns)
+            {
+                unique.insert(randomText(random, 1 + random() % 4, "abc"));
+            }
+            const std::vector<std::string> patterns(unique.begin(), unique.end());
+            const std::string text = randomText(random, random() % 60, "abcd");
+
+            std::vector<Match> expected;
+            for(size_t pattern = 0; pattern < patterns.size(); pattern++)
+            {
+                for(size_t location = text.find(patterns[pattern]); location != std::string::npos; location = text.find(patterns[pattern], location + 1))
+                {
+                    expected.push_back({location, patterns[pattern].length(), pattern});
+                }
+            }
+            const auto order = [](const Match& lhs, const Match& rhs) {
+                return std::tie(lhs.position, lhs.length, lhs.patternIndex) < std::tie(rhs.position, rhs.length, rhs.patternIndex);
+            };
+            std::sort(expected.begin(), expected.end(), order);
+
+            for(const auto direction : {MultiPatternMatcher::Direction::Forward, MultiPatternMatcher::Direction::Backward})
+            {
+                const bool forward = direction == MultiPatternMatcher::Direction::Forward;
+                const MultiPatternMatcher matcher(patterns, direction);
+                const std::string what = std::string(forward ? "Forward" : "Backward") + " MultiPatternMatcher on \"" + text + "\"";
+
+                std::vector<Match> all = matcher.findAll(text);
+                std::sort(all.begin(), all.end(), order);
+                check(all == expected, what + ": findAll");
+
+                // leftmost start going forwards, rightmost end going backwards, and the shorter match on a tie
+                std::optional<Match> expectedFirst;
+                for(const Match& match : expected)
+                {
+                    const auto better = [&](const Match& lhs, const Match& rhs) {
+                        return forward ? std::make_pair(lhs.position, lhs.length) < std::make_pair(rhs.position, rhs.length)
+                                       : std::make_pair(lhs.position + lhs.length, lhs.position) > std::make_pair(rhs.position + rhs.length, rhs.position);
+                    };
+                    if(!expectedFirst || better(match, *expectedFirst))
+                    {
+                        expectedFirst = match;
+                    }
+                }
+                check(matcher.findFirst(text) == expectedFirst, what + ": findFirst");
+            }
+        }
+    }
+
+    void testMappedFile()
+    {
+        std::mt19937 random(8);
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / ("smart_string_tests_" + std::to_string(random()) + ".txt");
+        for(int round = 0; round < 60; round++)
+        {
+            std::string contents;
+            const int numLines = round == 0 ? 0 : static_cast<int>(random() % 40);
+            for(int line = 0; line < numLines; line++)
+            {
+                contents += randomText(random, random() % 30, "abc ") + "\n";
+            }
+            if(round % 3 == 0 && !contents.empty())
+            {
+                contents.pop_back(); // no newline at the end of the file
+            }
+            {
+                std::ofstream file(path, std::ios::binary);
+                file << contents;
+            }
+
+            const Utilities::MappedFile file(path.string());
+            const std::string what = "MappedFile with " + std::to_string(numLines) + " lines";
+            check(file.view() == contents, what + ": view");
+            for(size_t numChunks = 1; numChunks <= 9; numChunks++)
+            {
+                const std::vector<std::string_view> chunks = file.splitLines(numChunks);
+                const std::string chunkWhat = what + ", splitLines(" + std::to_string(numChunks) + ")";
+                check(chunks.size() <= numChunks, chunkWhat + ": at most numChunks chunks");
+                std::string joined;
+                for(size_t i = 0; i < chunks.size(); i++)
+                {
+                    check(!chunks[i].empty(), chunkWhat + ": no empty chunks");
+                    check(i + 1 == chunks.size() || chunks[i].back() == '\n', chunkWhat + ": chunks end on a line boundary");
+                    joined += chunks[i];
+                }
+                check(joined == contents, chunkWhat + ": chunks cover the file in order");
+            }
+        }
+        std::filesystem::remove(path);
+    }
+
+
+    void testLineSum()
+    {
+        const auto parse = [](std::vector<std::string> arguments) {
+            arguments.insert(arguments.begin(), "program");
+            std::vector<char*> argv;
+            for(std::string& argument : arguments)
+            {
+                argv.push_back(argument.data());
+            }
+            return Utilities::parseLineSumOptions(static_cast<int>(argv.size()), argv.data());
+        };
+        const auto options = parse({"--verbose", "--threads", "12"});
+        check(options && options->threads == 12 && options->verbose, "parseLineSumOptions with both flags");
+        check(parse({}) && parse({})->threads == 1 && !parse({})->verbose, "parseLineSumOptions defaults");
+        for(const std::vector<std::string>& bad : std::vector<std::vector<std::string>>{
+                {"--threads"}, {"--threads", "0"}, {"--threads", "-2"}, {"--threads", "3x"}, {"--threads", ""}, {"--thread", "2"}, {"-v"}})
+        {
+            check(!parse(bad), "parseLineSumOptions rejects " + bad.front() + (bad.size() > 1 ? " " + bad.back() : ""));
+        }
+
+        std::ostringstream echo;
+        const auto length = [](const std::string_view line) { return static_cast<int>(line.length()); };
+        check(Utilities::sumLines("ab\n\nabcd", length, &echo) == 6, "sumLines over a chunk without a final newline");
+        check(echo.str() == "ab -> 2\n -> 0\nabcd -> 4\n", "sumLines echo");
+        check(Utilities::sumLines("abc\n", length, nullptr) == 3 && Utilities::sumLines("", length, nullptr) == 0, "sumLines edge cases");
+    }
+}
+
+int main()
+{
+    testAsciiKernelsOnEveryInstructionSet();
+    testSplit();
+    testTokens();
+    testTryConvert();
+    testReplaceAll();
+    testSearcher();
+    testFormat();
+    testAppendNumber();
+    testCharacterSet();
+    testArena();
+    testMultiPatternMatcher();
+    testMappedFile();
+    testLineSum();
+
+    return Tests::finish("SmartString");
+}